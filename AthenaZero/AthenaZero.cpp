@@ -43,10 +43,33 @@ int main()
 			validCommand = true;
 			exit = true;
 		}
-		else if (command == "perft")
+		else if (command == "perft" ||
+			command == "perft bitboard" ||
+			command == "perft legal" ||
+			command == "perft bitboard legal" ||
+			command == "perft bitboard copymake" ||
+			command == "perft bitboard legal copymake" ||
+			command == "perft bulk" ||
+			command == "perft bitboard bulk")
 		{
 			validCommand = true;
 			Perft perft;
+			if (command.find("bitboard") != std::string::npos)
+			{
+				perft.SetBoardType(Perft::BoardTypeBitboard);
+			}
+			if (command.find("legal") != std::string::npos)
+			{
+				perft.SetUseLegalMoveGeneration(true);
+			}
+			if (command.find("copymake") != std::string::npos)
+			{
+				perft.SetUseCopyMake(true);
+			}
+			if (command.find("bulk") != std::string::npos)
+			{
+				perft.SetUseBulkCounting(true);
+			}
 			PerftResults results = perft.RunAllPerftTests(0, false);
 			std::cout << "Result Count: " << results.GetCount() << std::endl << std::endl;
 
@@ -125,10 +148,23 @@ int main()
 				std::cout << std::endl << std::endl;
 			}
 
+			//The test files are found relative to the working directory, the project directory by default
+			std::cout << "FEN Files: ";
+			const bool fenFilesPassed = perft.RunFenFileTests("testdata/");
+			if (fenFilesPassed)
+			{
+				std::cout << "PASSED" << std::endl;
+			}
+			else
+			{
+				std::cout << "FAILED" << std::endl;
+			}
+			std::cout << std::endl;
+
 			std::cout << "Passed: " << passed << std::endl;
 			std::cout << "Failed: " << failed << std::endl;
 			std::cout << "Total: " << results.GetCount() << std::endl;
-			if (failed == 0)
+			if (failed == 0 && fenFilesPassed)
 			{
 				std::cout << " *** PASSED ***" << std::endl;
 			}
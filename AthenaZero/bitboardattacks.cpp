@@ -0,0 +1,228 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains code related to bitboard attack lookups. Leaper (knight,
+	king and pawn) attacks are simple per square tables. Slider (rook, bishop and
+	queen) attacks use magic bitboards.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bitboardattacks.h"
+#include "bitboardlib.h"
+#include "piece.h"
+
+namespace ATHENAZEROENG
+{
+	Bitboard BitboardAttacks::g_knightAttacks[64];
+	Bitboard BitboardAttacks::g_kingAttacks[64];
+	Bitboard BitboardAttacks::g_pawnAttacks[2][64];
+
+	MagicEntry BitboardAttacks::g_rookMagics[64];
+	MagicEntry BitboardAttacks::g_bishopMagics[64];
+
+	Bitboard BitboardAttacks::g_rookTable[BitboardAttacks::RookTableLength];
+	Bitboard BitboardAttacks::g_bishopTable[BitboardAttacks::BishopTableLength];
+
+	Bitboard BitboardAttacks::g_between[64][64];
+	Bitboard BitboardAttacks::g_line[64][64];
+
+	void BitboardAttacks::Initialise()
+	{
+		//Function level statics are only initialised once (and are thread safe)
+		static const bool initialised = InitialiseTables();
+		(void)initialised;
+	}
+
+	bool BitboardAttacks::InitialiseTables()
+	{
+		InitialiseLeaperAttacks();
+		InitialiseSliderAttacks(true, g_rookMagics, g_rookTable);
+		InitialiseSliderAttacks(false, g_bishopMagics, g_bishopTable);
+		InitialiseLines();
+		return true;
+	}
+
+	void BitboardAttacks::InitialiseLeaperAttacks()
+	{
+		static constexpr int knightFiles[8] = { 1, 2, 2, 1, -1, -2, -2, -1 };
+		static constexpr int knightRanks[8] = { 2, 1, -1, -2, -2, -1, 1, 2 };
+		static constexpr int kingFiles[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+		static constexpr int kingRanks[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+
+		for (int sq = 0; sq < 64; ++sq)
+		{
+			int file = sq & 7;
+			int rank = sq >> 3;
+
+			g_knightAttacks[sq] = 0;
+			g_kingAttacks[sq] = 0;
+
+			for (int i = 0; i < 8; ++i)
+			{
+				int f = file + knightFiles[i];
+				int r = rank + knightRanks[i];
+				if (f >= 0 && f < 8 && r >= 0 && r < 8)
+				{
+					g_knightAttacks[sq] |= SquareBitboard(r * 8 + f);
+				}
+
+				f = file + kingFiles[i];
+				r = rank + kingRanks[i];
+				if (f >= 0 && f < 8 && r >= 0 && r < 8)
+				{
+					g_kingAttacks[sq] |= SquareBitboard(r * 8 + f);
+				}
+			}
+
+			Bitboard b = SquareBitboard(sq);
+			g_pawnAttacks[Piece::ColourIndexWhite][sq] = ((b & ~FileABitboard) << 7) | ((b & ~FileHBitboard) << 9);
+			g_pawnAttacks[Piece::ColourIndexBlack][sq] = ((b & ~FileABitboard) >> 9) | ((b & ~FileHBitboard) >> 7);
+		}
+	}
+
+	void BitboardAttacks::InitialiseLines()
+	{
+		for (BoardIndex64 a = 0; a < 64; ++a)
+		{
+			for (BoardIndex64 b = 0; b < 64; ++b)
+			{
+				g_between[a][b] = 0;
+				g_line[a][b] = 0;
+
+				const Bitboard aBitboard = SquareBitboard(a);
+				const Bitboard bBitboard = SquareBitboard(b);
+
+				if ((GetRookAttacks(a, 0) & bBitboard) != 0)
+				{
+					//Each square blocks the other's ray so only the squares between are common
+					g_between[a][b] = GetRookAttacks(a, bBitboard) & GetRookAttacks(b, aBitboard);
+					g_line[a][b] = (GetRookAttacks(a, 0) & GetRookAttacks(b, 0)) | aBitboard | bBitboard;
+				}
+				else if ((GetBishopAttacks(a, 0) & bBitboard) != 0)
+				{
+					g_between[a][b] = GetBishopAttacks(a, bBitboard) & GetBishopAttacks(b, aBitboard);
+					g_line[a][b] = (GetBishopAttacks(a, 0) & GetBishopAttacks(b, 0)) | aBitboard | bBitboard;
+				}
+			}
+		}
+	}
+
+	void BitboardAttacks::InitialiseSliderAttacks(bool isRook, MagicEntry* magics, Bitboard* table)
+	{
+		//Every subset of a mask has at most 4096 (2^12) entries
+		Bitboard occupancies[4096];
+		Bitboard references[4096];
+		//Used to detect collisions without clearing the table for each try
+		int epoch[4096] = { 0 };
+		int attempt = 0;
+
+		//Fixed seed so the magics (and so start-up time) are the same on each run
+		unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+		auto random = [&seed]()
+		{
+			//xorshift64*
+			seed ^= seed >> 12;
+			seed ^= seed << 25;
+			seed ^= seed >> 27;
+			return seed * 2685821657736338717ULL;
+		};
+
+		Bitboard* attacks = table;
+
+		for (BoardIndex64 sq = 0; sq < 64; ++sq)
+		{
+			MagicEntry& entry = magics[sq];
+			entry.Mask = SlowSliderAttacks(isRook, sq, 0, true);
+			entry.Shift = 64 - PopCount(entry.Mask);
+			entry.Attacks = attacks;
+
+			//Enumerate all subsets of the mask (Carry-Rippler)
+			int size = 0;
+			Bitboard b = 0;
+			do
+			{
+				occupancies[size] = b;
+				references[size] = SlowSliderAttacks(isRook, sq, b, false);
+				++size;
+				b = (b - entry.Mask) & entry.Mask;
+			} while (b != 0);
+
+			//Try sparse random numbers until one maps every subset without a destructive collision
+			bool found = false;
+			while (!found)
+			{
+				entry.Magic = random() & random() & random();
+				if (PopCount((entry.Mask * entry.Magic) >> 56) < 6) continue;
+
+				++attempt;
+				found = true;
+				for (int i = 0; i < size; ++i)
+				{
+					unsigned int index = static_cast<unsigned int>((occupancies[i] * entry.Magic) >> entry.Shift);
+					if (epoch[index] < attempt)
+					{
+						epoch[index] = attempt;
+						attacks[index] = references[i];
+					}
+					else if (attacks[index] != references[i])
+					{
+						found = false;
+						break;
+					}
+				}
+			}
+
+			attacks += size;
+		}
+	}
+
+	Bitboard BitboardAttacks::SlowSliderAttacks(bool isRook, BoardIndex64 sq64, Bitboard occupancy, bool excludeEdges)
+	{
+		static constexpr int rookFiles[4] = { 0, 0, 1, -1 };
+		static constexpr int rookRanks[4] = { 1, -1, 0, 0 };
+		static constexpr int bishopFiles[4] = { 1, 1, -1, -1 };
+		static constexpr int bishopRanks[4] = { 1, -1, 1, -1 };
+
+		const int* fileDirections = isRook ? rookFiles : bishopFiles;
+		const int* rankDirections = isRook ? rookRanks : bishopRanks;
+
+		Bitboard attacks = 0;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			int f = (sq64 & 7) + fileDirections[i];
+			int r = (sq64 >> 3) + rankDirections[i];
+
+			while (f >= 0 && f < 8 && r >= 0 && r < 8)
+			{
+				if (excludeEdges)
+				{
+					int nextFile = f + fileDirections[i];
+					int nextRank = r + rankDirections[i];
+					if (nextFile < 0 || nextFile > 7 || nextRank < 0 || nextRank > 7) break;
+				}
+
+				Bitboard b = SquareBitboard(r * 8 + f);
+				attacks |= b;
+				if ((occupancy & b) != 0) break; //Blocked
+
+				f += fileDirections[i];
+				r += rankDirections[i];
+			}
+		}
+
+		return attacks;
+	}
+}
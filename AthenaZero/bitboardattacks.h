@@ -0,0 +1,196 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains code related to bitboard attack lookups. Leaper (knight,
+	king and pawn) attacks are simple per square tables. Slider (rook, bishop and
+	queen) attacks use magic bitboards.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATHENAZERO_ENGINE_BITBOARDATTACKS
+#define ATHENAZERO_ENGINE_BITBOARDATTACKS
+
+#include "typedefs.h"
+#include "bitboardlib.h"
+
+namespace ATHENAZEROENG
+{
+	/*
+		The magic lookup details for a single square.
+
+		The attack index is ((occupancy & Mask) * Magic) >> Shift.
+	*/
+	class MagicEntry
+	{
+	public:
+		//Relevant occupancy squares (the slider rays excluding the board edge)
+		Bitboard Mask{ 0 };
+		Bitboard Magic{ 0 };
+		//The start of this square's part of the attack table
+		Bitboard* Attacks{ nullptr };
+		unsigned int Shift{ 0 };
+	};
+
+	class BitboardAttacks
+	{
+	public:
+		/*
+			Builds all lookup tables (including finding the magic numbers). Only
+			does the work on the first call so is safe to call more than once.
+		*/
+		static void Initialise();
+
+		/*
+			Gets the squares attacked by a knight on the specified square.
+		*/
+		static inline Bitboard GetKnightAttacks(BoardIndex64 sq64)
+		{
+			return g_knightAttacks[sq64];
+		}
+
+		/*
+			Gets the squares attacked by a king on the specified square.
+		*/
+		static inline Bitboard GetKingAttacks(BoardIndex64 sq64)
+		{
+			return g_kingAttacks[sq64];
+		}
+
+		/*
+			Gets the squares attacked by a pawn on the specified square.
+
+			colourIndex: The pawn's colour, Piece::ColourIndexWhite or Piece::ColourIndexBlack.
+			sq64: The square the pawn is on.
+		*/
+		static inline Bitboard GetPawnAttacks(int colourIndex, BoardIndex64 sq64)
+		{
+			return g_pawnAttacks[colourIndex][sq64];
+		}
+
+		/*
+			Gets the squares attacked by a rook on the specified square. Includes
+			the first blocker in each direction (of either colour).
+
+			sq64: The square the rook is on.
+			occupancy: All occupied squares.
+		*/
+		static inline Bitboard GetRookAttacks(BoardIndex64 sq64, Bitboard occupancy)
+		{
+			const MagicEntry& entry = g_rookMagics[sq64];
+			return entry.Attacks[((occupancy & entry.Mask) * entry.Magic) >> entry.Shift];
+		}
+
+		/*
+			Gets the squares attacked by a bishop on the specified square. Includes
+			the first blocker in each direction (of either colour).
+
+			sq64: The square the bishop is on.
+			occupancy: All occupied squares.
+		*/
+		static inline Bitboard GetBishopAttacks(BoardIndex64 sq64, Bitboard occupancy)
+		{
+			const MagicEntry& entry = g_bishopMagics[sq64];
+			return entry.Attacks[((occupancy & entry.Mask) * entry.Magic) >> entry.Shift];
+		}
+
+		/*
+			Gets the squares attacked by a queen on the specified square. Includes
+			the first blocker in each direction (of either colour).
+
+			sq64: The square the queen is on.
+			occupancy: All occupied squares.
+		*/
+		static inline Bitboard GetQueenAttacks(BoardIndex64 sq64, Bitboard occupancy)
+		{
+			return GetRookAttacks(sq64, occupancy) | GetBishopAttacks(sq64, occupancy);
+		}
+
+		/*
+			Gets the squares strictly between two squares that share a rank, file or
+			diagonal. Empty if the squares are not aligned.
+		*/
+		static inline Bitboard GetBetween(BoardIndex64 sq64a, BoardIndex64 sq64b)
+		{
+			return g_between[sq64a][sq64b];
+		}
+
+		/*
+			Gets the whole rank, file or diagonal (edge to edge) through two aligned
+			squares. Empty if the squares are not aligned.
+		*/
+		static inline Bitboard GetLine(BoardIndex64 sq64a, BoardIndex64 sq64b)
+		{
+			return g_line[sq64a][sq64b];
+		}
+
+	private:
+		//Total attack table sizes, the sum of 2^(relevant bits) over all squares.
+		static constexpr int RookTableLength = 102400;
+		static constexpr int BishopTableLength = 5248;
+
+		static Bitboard g_knightAttacks[64];
+		static Bitboard g_kingAttacks[64];
+		static Bitboard g_pawnAttacks[2][64];
+
+		static MagicEntry g_rookMagics[64];
+		static MagicEntry g_bishopMagics[64];
+
+		static Bitboard g_rookTable[RookTableLength];
+		static Bitboard g_bishopTable[BishopTableLength];
+
+		static Bitboard g_between[64][64];
+		static Bitboard g_line[64][64];
+
+		/*
+			Builds all the tables. Called once by Initialise().
+
+			Returns: True (used to initialise a static).
+		*/
+		static bool InitialiseTables();
+
+		/*
+			Builds the leaper (knight, king and pawn) tables.
+		*/
+		static void InitialiseLeaperAttacks();
+
+		/*
+			Builds the between and line tables. Uses the slider attacks so must be
+			called after they are built.
+		*/
+		static void InitialiseLines();
+
+		/*
+			Finds magic numbers and fills the attack table for one slider type.
+
+			isRook: True for rooks, false for bishops.
+			magics: The 64 entries to fill.
+			table: The attack table shared between all 64 squares.
+		*/
+		static void InitialiseSliderAttacks(bool isRook, MagicEntry* magics, Bitboard* table);
+
+		/*
+			Generates slider attacks the slow way, walking each ray one square at a time.
+			Only used to build the lookup tables.
+
+			isRook: True for rooks, false for bishops.
+			sq64: The slider's square.
+			occupancy: All occupied squares.
+			excludeEdges: If true the last square of each ray is not included (used to build the masks).
+		*/
+		static Bitboard SlowSliderAttacks(bool isRook, BoardIndex64 sq64, Bitboard occupancy, bool excludeEdges);
+	};
+}
+
+#endif
@@ -0,0 +1,117 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains code related to bitboard representation tasks such as
+	bit counting and converting between bitboard squares and 0x88 squares.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATHENAZERO_ENGINE_BITBOARDLIB
+#define ATHENAZERO_ENGINE_BITBOARDLIB
+
+#include "typedefs.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ATHENAZEROENG
+{
+	//Bitboard squares are 0-63 where a1 = 0, b1 = 1, ..., h8 = 63.
+	static constexpr BoardIndex64 NullSquare64 = 64;
+
+	static constexpr Bitboard FileABitboard = 0x0101010101010101ULL;
+	static constexpr Bitboard FileHBitboard = 0x8080808080808080ULL;
+	static constexpr Bitboard Rank1Bitboard = 0x00000000000000FFULL;
+	static constexpr Bitboard Rank3Bitboard = 0x0000000000FF0000ULL;
+	static constexpr Bitboard Rank6Bitboard = 0x0000FF0000000000ULL;
+	static constexpr Bitboard Rank8Bitboard = 0xFF00000000000000ULL;
+
+	/*
+		Gets a bitboard with only the specified square set.
+
+		sq64: The square (0-63).
+	*/
+	inline Bitboard SquareBitboard(BoardIndex64 sq64)
+	{
+		return 1ULL << sq64;
+	}
+
+	/*
+		Counts the number of set bits.
+
+		bitboard: The bitboard.
+		Returns: The number of squares set.
+	*/
+	inline int PopCount(Bitboard bitboard)
+	{
+#ifdef _MSC_VER
+		return static_cast<int>(__popcnt64(bitboard));
+#else
+		return __builtin_popcountll(bitboard);
+#endif
+	}
+
+	/*
+		Gets the least significant set bit. Does no validation, so do NOT call
+		with an empty bitboard.
+
+		bitboard: The bitboard, must not be 0.
+		Returns: The square (0-63) of the least significant bit.
+	*/
+	inline BoardIndex64 LeastSignificantSquare(Bitboard bitboard)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, bitboard);
+		return static_cast<BoardIndex64>(index);
+#else
+		return static_cast<BoardIndex64>(__builtin_ctzll(bitboard));
+#endif
+	}
+
+	/*
+		Removes the least significant set bit and returns its square. Does no
+		validation, so do NOT call with an empty bitboard.
+
+		bitboard: The bitboard, must not be 0. Modified to remove the bit.
+		Returns: The square (0-63) of the removed bit.
+	*/
+	inline BoardIndex64 PopLeastSignificantSquare(Bitboard& bitboard)
+	{
+		BoardIndex64 sq64 = LeastSignificantSquare(bitboard);
+		bitboard &= bitboard - 1;
+		return sq64;
+	}
+
+	/*
+		Converts a bitboard square (0-63) to the 0x88 board index.
+	*/
+	inline BoardIndex0x88 Sq64To0x88(BoardIndex64 sq64)
+	{
+		return sq64 + (sq64 & 0x38);
+	}
+
+	/*
+		Converts a 0x88 board index to the bitboard square (0-63). Does no
+		validation so only pass valid 0x88 squares.
+	*/
+	inline BoardIndex64 Sq0x88To64(BoardIndex0x88 sq0x88)
+	{
+		return (sq0x88 + (sq0x88 & 7)) >> 1;
+	}
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains the complete position held by a BoardBitboard in one small,
+	trivially copyable structure so it can be saved and restored with a single copy.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATHENAZERO_ENGINE_BITBOARDPOSITION
+#define ATHENAZERO_ENGINE_BITBOARDPOSITION
+
+#include <type_traits>
+
+#include "piece.h"
+#include "typedefs.h"
+#include "bitboardlib.h"
+
+namespace ATHENAZEROENG
+{
+	/*
+		A position for BoardBitboard. Kept free of pointers and constructors other than
+		member initialisers so it can be copied as raw bytes (e.g. copy-make, or handing a
+		position to another thread).
+	*/
+	class BitboardPosition
+	{
+	public:
+		//One set per piece type, indexed by Piece::PieceIndexXXX
+		Bitboard Pieces[Piece::PieceTypeCount];
+
+		//One set per colour, indexed by Piece::ColourIndexXXX
+		Bitboard Colours[2];
+
+		//Piece::ColourIndexWhite or Piece::ColourIndexBlack
+		unsigned char ColourToMove{ Piece::ColourIndexWhite };
+
+		//Combination of the BoardBitboard::CastleXXX values
+		unsigned char CastlingRights{ 0 };
+
+		//The square passed over by a double pawn move, NullSquare64 if none
+		unsigned char EnpassantTargetSquare{ NullSquare64 };
+
+		//Starts at zero. Inceremented after every ply, reset to 0 after a pawn move or capture.
+		unsigned short HalfMoveClock{ 0 };
+
+		//Starts at 1 and increments after black's move.
+		unsigned short FullMoveNumber{ 1 };
+	};
+
+	static_assert(std::is_trivially_copyable<BitboardPosition>::value, "BitboardPosition must be trivially copyable");
+	static_assert(sizeof(BitboardPosition) <= 72, "BitboardPosition should stay small, it is copied for every move made");
+}
+
+#endif
@@ -18,7 +18,9 @@
 	along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <sstream>
+#include <string>
+#include <cstring>
+#include <cassert>
 
 #include "board.h"
 #include "move.h"
@@ -30,85 +32,1180 @@
 
 namespace ATHENAZEROENG
 {
+	unsigned char Board::g_attackDeltaPieces[Board::AttackDeltaLength];
+	signed char Board::g_attackDeltaSteps[Board::AttackDeltaLength];
+
 	Board::Board()
 	{
-		//Create unmake move list
-		g_UnmakeList = new UnmakeItem[InitialUnmakeMoveListCapacity];
-		g_UnmakeLength = { 0 };
-		g_UnmakeCapacity = { InitialUnmakeMoveListCapacity };
+		Zobrist::Initialise();
+		BitboardAttacks::Initialise();
+		InitialiseAttackDeltas();
 
 		//Setup the initial position
 		NewGame();
 	}
 
-	Board::~Board()
+	Board::Board(const Board& other)
+	{
+		CopyFrom(other);
+	}
+
+	Board& Board::operator=(const Board& other)
+	{
+		if (this != &other) CopyFrom(other);
+		return *this;
+	}
+
+	Board::Board(Board&& other) noexcept
 	{
-		delete[] g_UnmakeList;
+		CopyFrom(other);
+	}
+
+	Board& Board::operator=(Board&& other) noexcept
+	{
+		if (this != &other) CopyFrom(other);
+		return *this;
+	}
+
+	void Board::CopyFrom(const Board& other)
+	{
+		g_state = other.g_state;
+		std::memcpy(g_board, other.g_board, sizeof(g_board));
+		std::memcpy(g_pieceListIndex, other.g_pieceListIndex, sizeof(g_pieceListIndex));
+		std::memcpy(g_pieceList, other.g_pieceList, sizeof(g_pieceList));
+		std::memcpy(g_pieceCount, other.g_pieceCount, sizeof(g_pieceCount));
+		std::memcpy(g_pieceBitboards, other.g_pieceBitboards, sizeof(g_pieceBitboards));
+		std::memcpy(g_colourBitboards, other.g_colourBitboards, sizeof(g_colourBitboards));
+
+		g_UnmakeLength = other.g_UnmakeLength;
+		std::memcpy(g_UnmakeList, other.g_UnmakeList, g_UnmakeLength * sizeof(UnmakeItem));
+
+		g_key = other.g_key;
+		g_pawnKey = other.g_pawnKey;
+		g_materialSignature = other.g_materialSignature;
 	}
 
 	void Board::NewGame()
 	{
+		g_UnmakeLength = { 0 };
+
 		ClearBoard();
 		SetupPawns(true);
 		SetupPawns(false);
 		SetupPieces(true);
 		SetupPieces(false);
 
-		g_colourToMove = { Piece::PieceColourWhite };
-		g_canWhiteCastleKingSide = { true };
-		g_canWhiteCastleQueenSide = { true };
-		g_canBlackCastleKingSide = { true };
-		g_canBlackCastleQueenSide = { true };
-		g_EnpassantTargetSquare = { Null0x88Square };
-		g_WhiteKingLocation0x88 = { 0x04 };
-		g_BlackKingLocation0x88 = { 0x74 };
-		g_halfMoveClock = { 0 };
-		g_fullMoveNumber = { 1 };
+		g_state.ColourToMove = { Piece::PieceColourWhite };
+		g_state.CastlingRights = { BoardState::CastleAll };
+		g_state.EnpassantTargetSquare = { Null0x88Square };
+		g_state.WhiteKingLocation0x88 = { 0x04 };
+		g_state.BlackKingLocation0x88 = { 0x74 };
+		g_state.HalfMoveClock = { 0 };
+		g_state.FullMoveNumber = { 1 };
+
+		RebuildPieceLists();
+		RebuildPieceBitboards();
+		g_key = CalculateKey();
+		g_pawnKey = CalculatePawnKey();
+		g_materialSignature = CalculateMaterialSignature();
 	}
 
 	void Board::GeneratePseudoLegalMoves(Move* moves, int& moveCount)
 	{
+		if (g_state.ColourToMove == Piece::PieceColourWhite)
+		{
+			GeneratePseudoLegalMoves<Piece::PieceColourWhite>(moves, moveCount);
+		}
+		else
+		{
+			GeneratePseudoLegalMoves<Piece::PieceColourBlack>(moves, moveCount);
+		}
+	}
+
+	template <int Us>
+	void Board::GeneratePseudoLegalMoves(Move* moves, int& moveCount)
+	{
+		if (IsSquareAttacked(GetKingSquare<Us>(), Piece::OtherColour(Us)))
+		{
+			GenerateEvasions<Us>(moves, moveCount);
+		}
+		else
+		{
+			GenerateMoves<Us>(MoveGenerationAll, moves, moveCount);
+		}
+	}
+
+	void Board::GenerateMoves(int generationType, Move* moves, int& moveCount)
+	{
+		if (g_state.ColourToMove == Piece::PieceColourWhite)
+		{
+			GenerateMoves<Piece::PieceColourWhite>(generationType, moves, moveCount);
+		}
+		else
+		{
+			GenerateMoves<Piece::PieceColourBlack>(generationType, moves, moveCount);
+		}
+	}
+
+	template <int Us>
+	void Board::GenerateMoves(int generationType, Move* moves, int& moveCount)
+	{
+		moveCount = 0;
+
+		//Only visit the pieces that exist using the piece lists
+		constexpr int colourIndex = Piece::ColourToIndex(Us);
+		const CompactBoardIndex0x88(&pieceList)[Piece::PieceTypeCount][MaxPiecesPerType] = g_pieceList[colourIndex];
+		const int(&pieceCount)[Piece::PieceTypeCount] = g_pieceCount[colourIndex];
+
+		for (int i = 0; i < pieceCount[Piece::PieceIndexPawn]; ++i)
+		{
+			AddPawnMoves<Us>(pieceList[Piece::PieceIndexPawn][i], generationType, moves, moveCount);
+		}
+
+		for (int i = 0; i < pieceCount[Piece::PieceIndexKnight]; ++i)
+		{
+			AddKnightMoves(pieceList[Piece::PieceIndexKnight][i], generationType, moves, moveCount);
+		}
+
+		for (int i = 0; i < pieceCount[Piece::PieceIndexBishop]; ++i)
+		{
+			AddBishopMoves(pieceList[Piece::PieceIndexBishop][i], generationType, moves, moveCount);
+		}
+
+		for (int i = 0; i < pieceCount[Piece::PieceIndexRook]; ++i)
+		{
+			AddRookMoves(pieceList[Piece::PieceIndexRook][i], generationType, moves, moveCount);
+		}
+
+		for (int i = 0; i < pieceCount[Piece::PieceIndexQueen]; ++i)
+		{
+			AddQueenMoves(pieceList[Piece::PieceIndexQueen][i], generationType, moves, moveCount);
+		}
+
+		for (int i = 0; i < pieceCount[Piece::PieceIndexKing]; ++i)
+		{
+			AddKingMoves(pieceList[Piece::PieceIndexKing][i], generationType, moves, moveCount);
+		}
+
+		if ((generationType & MoveGenerationQuiet) != 0)
+		{
+			AddCastlingMoves<Us>(moves, moveCount);
+		}
+	}
+
+	void Board::GenerateCaptures(Move* moves, int& moveCount)
+	{
+		if (g_state.ColourToMove == Piece::PieceColourWhite)
+		{
+			GenerateCaptures<Piece::PieceColourWhite>(moves, moveCount);
+		}
+		else
+		{
+			GenerateCaptures<Piece::PieceColourBlack>(moves, moveCount);
+		}
+	}
+
+	template <int Us>
+	void Board::GenerateCaptures(Move* moves, int& moveCount)
+	{
+		static constexpr int victimIndexes[5] = {
+			Piece::PieceIndexQueen, Piece::PieceIndexRook, Piece::PieceIndexBishop, Piece::PieceIndexKnight, Piece::PieceIndexPawn };
+
 		moveCount = 0;
 
-		for (int sq = 0; sq < BoardArrayFirstNotPiecePos; ++sq)
+		constexpr bool isWhite = Us == Piece::PieceColourWhite;
+		constexpr int colourIndex = Piece::ColourToIndex(Us);
+		constexpr int otherColourIndex = Piece::ColourToIndex(Piece::OtherColour(Us));
+		constexpr PackedPiece ownPawn = Piece::Pack(Piece::PieceTypePawn, Us);
+
+		//Every piece attacking an enemy piece can capture it
+		for (int i = 0; i < 5; ++i)
 		{
-			if (Is0x88SquareValid(sq))
+			const int victimIndex = victimIndexes[i];
+			for (int j = 0; j < g_pieceCount[otherColourIndex][victimIndex]; ++j)
 			{
-				Piece& p = g_board[sq];
-				if (p.PieceColour == g_colourToMove)
+				const BoardIndex0x88 target = g_pieceList[otherColourIndex][victimIndex][j];
+				Bitboard targetAttackers = GetAttackersOfIndex(Sq0x88To64(target), colourIndex);
+				while (targetAttackers != 0)
 				{
-					switch (p.PieceType)
+					const BoardIndex0x88 start = Sq64To0x88(PopLeastSignificantSquare(targetAttackers));
+					if (g_board[start] == ownPawn)
 					{
-					case Piece::PieceTypeRook:
-						AddRookMoves(sq, moves, moveCount);
-						break;
-					case Piece::PieceTypeKnight:
-						AddKnightMoves(sq, moves, moveCount);
-						break;
-					case Piece::PieceTypeBishop:
-						AddBishopMoves(sq, moves, moveCount);
-						break;
-					case Piece::PieceTypeQueen:
-						AddQueenMoves(sq, moves, moveCount);
-						break;
-					case Piece::PieceTypeKing:
-						AddKingMoves(sq, moves, moveCount);
-						break;
-					case Piece::PieceTypePawn:
-						AddPawnMoves(sq, moves, moveCount);
+						//Includes promotions on the capture
+						AddPawnCapture<Us>(start, target - start, moves, moveCount);
+					}
+					else
+					{
+						AddMove(
+							start,
+							target,
+							Move::MoveFlagCapture,
+							moves,
+							moveCount);
+					}
+				}
+			}
+		}
+
+		//Enpassant, the victim is a pawn so it follows the pawn captures
+		if (g_state.EnpassantTargetSquare != Null0x88Square)
+		{
+			const BoardIndex0x88 target = g_state.EnpassantTargetSquare;
+			constexpr int captureLeft = isWhite ? BoardDirPawnCaptureLeftWhite : BoardDirPawnCaptureLeftBlack;
+			constexpr int captureRight = isWhite ? BoardDirPawnCaptureRightWhite : BoardDirPawnCaptureRightBlack;
+
+			BoardIndex0x88 start = target - captureLeft;
+			if (Is0x88SquareValid(start) && g_board[start] == ownPawn)
+			{
+				AddMove(
+					start,
+					target,
+					Move::MoveFlagEnpassant,
+					moves,
+					moveCount);
+			}
+
+			start = target - captureRight;
+			if (Is0x88SquareValid(start) && g_board[start] == ownPawn)
+			{
+				AddMove(
+					start,
+					target,
+					Move::MoveFlagEnpassant,
+					moves,
+					moveCount);
+			}
+		}
+
+		//Promotions that do not capture, no victim so last
+		for (int i = 0; i < g_pieceCount[colourIndex][Piece::PieceIndexPawn]; ++i)
+		{
+			const BoardIndex0x88 start = g_pieceList[colourIndex][Piece::PieceIndexPawn][i];
+			AddPawnAdvance<Us>(start, start, false, MoveGenerationNoisy, moves, moveCount);
+		}
+	}
+
+	void Board::GenerateEvasions(Move* moves, int& moveCount)
+	{
+		if (g_state.ColourToMove == Piece::PieceColourWhite)
+		{
+			GenerateEvasions<Piece::PieceColourWhite>(moves, moveCount);
+		}
+		else
+		{
+			GenerateEvasions<Piece::PieceColourBlack>(moves, moveCount);
+		}
+	}
+
+	template <int Us>
+	void Board::GenerateEvasions(Move* moves, int& moveCount)
+	{
+		moveCount = 0;
+
+		constexpr bool isWhite = Us == Piece::PieceColourWhite;
+		constexpr int colourIndex = Piece::ColourToIndex(Us);
+		const BoardIndex0x88 kingSquare = GetKingSquare<Us>();
+		const Bitboard checkers = GetAttackersOfIndex(Sq0x88To64(kingSquare), colourIndex ^ 1);
+
+		AddLegalKingMoves<Us>(kingSquare, true, moves, moveCount);
+
+		//Only the king can move out of double check
+		if ((checkers & (checkers - 1)) != 0) return;
+
+		const BoardIndex0x88 checkerSquare = Sq64To0x88(LeastSignificantSquare(checkers));
+		constexpr PackedPiece ownPawn = Piece::Pack(Piece::PieceTypePawn, Us);
+		constexpr int pawnAdvance = isWhite ? BoardDirPawnAdvanceSingleWhite : BoardDirPawnAdvanceSingleBlack;
+
+		//Capture the checking piece
+		Bitboard capturers = GetAttackersOfIndex(Sq0x88To64(checkerSquare), colourIndex);
+		while (capturers != 0)
+		{
+			const BoardIndex0x88 start = Sq64To0x88(PopLeastSignificantSquare(capturers));
+			switch (Piece::GetPackedType(g_board[start]))
+			{
+			case Piece::PieceTypeKing:
+				break; //Added with the king moves
+			case Piece::PieceTypePawn:
+				AddPawnCapture<Us>(start, checkerSquare - start, moves, moveCount);
+				break;
+			default:
+				AddMove(
+					start,
+					checkerSquare,
+					Move::MoveFlagCapture,
+					moves,
+					moveCount);
+				break;
+			}
+		}
+
+		//Block a checking slider
+		const int checkerType = Piece::GetPackedType(g_board[checkerSquare]);
+		bool canBlockOnEnpassantSquare = false;
+		if (checkerType == Piece::PieceTypeRook || checkerType == Piece::PieceTypeBishop || checkerType == Piece::PieceTypeQueen)
+		{
+			const int direction = GetAttackStep(kingSquare, checkerSquare);
+			for (BoardIndex0x88 target = kingSquare + direction; target != checkerSquare; target += direction)
+			{
+				if (target == g_state.EnpassantTargetSquare) canBlockOnEnpassantSquare = true;
+
+				//The target is empty so every piece attacking it can move there, apart from pawns and the king
+				Bitboard blockers = GetAttackersOfIndex(Sq0x88To64(target), colourIndex);
+				while (blockers != 0)
+				{
+					const BoardIndex0x88 start = Sq64To0x88(PopLeastSignificantSquare(blockers));
+					const int pieceType = Piece::GetPackedType(g_board[start]);
+					if (pieceType == Piece::PieceTypePawn || pieceType == Piece::PieceTypeKing) continue;
+
+					AddMove(
+						start,
+						target,
+						Move::MoveFlagQuiet,
+						moves,
+						moveCount);
+				}
+
+				//Pawn advances onto the target
+				const BoardIndex0x88 singleStart = target - pawnAdvance;
+				if (!Is0x88SquareValid(singleStart)) continue;
+
+				if (g_board[singleStart] == ownPawn)
+				{
+					AddPawnAdvance<Us>(singleStart, singleStart, false, MoveGenerationAll, moves, moveCount);
+				}
+				else if (g_board[singleStart] == Piece::PackedPieceNone && (target & 0x70) == (isWhite ? 0x30 : 0x40))
+				{
+					const BoardIndex0x88 doubleStart = singleStart - pawnAdvance;
+					if (g_board[doubleStart] == ownPawn)
+					{
+						AddMove(
+							doubleStart,
+							target,
+							Move::MoveFlagDoublePawnPush,
+							moves,
+							moveCount);
+					}
+				}
+			}
+		}
+
+		//Enpassant, capturing the checking pawn or blocking on the square it passed over
+		if (g_state.EnpassantTargetSquare != Null0x88Square &&
+			(canBlockOnEnpassantSquare || checkerSquare + pawnAdvance == g_state.EnpassantTargetSquare))
+		{
+			const BoardIndex0x88 target = g_state.EnpassantTargetSquare;
+			constexpr int captureLeft = isWhite ? BoardDirPawnCaptureLeftWhite : BoardDirPawnCaptureLeftBlack;
+			constexpr int captureRight = isWhite ? BoardDirPawnCaptureRightWhite : BoardDirPawnCaptureRightBlack;
+
+			BoardIndex0x88 start = target - captureLeft;
+			if (Is0x88SquareValid(start) && g_board[start] == ownPawn)
+			{
+				AddMove(
+					start,
+					target,
+					Move::MoveFlagEnpassant,
+					moves,
+					moveCount);
+			}
+
+			start = target - captureRight;
+			if (Is0x88SquareValid(start) && g_board[start] == ownPawn)
+			{
+				AddMove(
+					start,
+					target,
+					Move::MoveFlagEnpassant,
+					moves,
+					moveCount);
+			}
+		}
+	}
+
+	void Board::GenerateLegalMoves(Move* moves, int& moveCount)
+	{
+		if (g_state.ColourToMove == Piece::PieceColourWhite)
+		{
+			GenerateLegalMoves<Piece::PieceColourWhite>(moves, moveCount);
+		}
+		else
+		{
+			GenerateLegalMoves<Piece::PieceColourBlack>(moves, moveCount);
+		}
+	}
+
+	template <int Us>
+	void Board::GenerateLegalMoves(Move* moves, int& moveCount)
+	{
+		moveCount = 0;
+
+		const BoardIndex0x88 kingSquare = GetKingSquare<Us>();
+
+		BoardIndex0x88 checkBlockSquares[MaxCheckBlockSquares];
+		int checkBlockCount = 0;
+		BoardIndex0x88 pinnedSquares[MaxPinnedPieces];
+		int pinDirections[MaxPinnedPieces];
+		int pinnedCount = 0;
+
+		const int checkCount = FindChecksAndPins<Us>(kingSquare, checkBlockSquares, checkBlockCount, pinnedSquares, pinDirections, pinnedCount);
+
+		if (checkCount < 2)
+		{
+			//Only the king can move out of double check, otherwise generate the other pieces' moves
+			//and keep the ones that do not expose the king
+			constexpr int colourIndex = Piece::ColourToIndex(Us);
+			const CompactBoardIndex0x88(&pieceList)[Piece::PieceTypeCount][MaxPiecesPerType] = g_pieceList[colourIndex];
+			const int(&pieceCount)[Piece::PieceTypeCount] = g_pieceCount[colourIndex];
+			const int generationType = MoveGenerationAll;
+
+			for (int i = 0; i < pieceCount[Piece::PieceIndexPawn]; ++i)
+			{
+				AddPawnMoves<Us>(pieceList[Piece::PieceIndexPawn][i], generationType, moves, moveCount);
+			}
+
+			for (int i = 0; i < pieceCount[Piece::PieceIndexKnight]; ++i)
+			{
+				AddKnightMoves(pieceList[Piece::PieceIndexKnight][i], generationType, moves, moveCount);
+			}
+
+			for (int i = 0; i < pieceCount[Piece::PieceIndexBishop]; ++i)
+			{
+				AddBishopMoves(pieceList[Piece::PieceIndexBishop][i], generationType, moves, moveCount);
+			}
+
+			for (int i = 0; i < pieceCount[Piece::PieceIndexRook]; ++i)
+			{
+				AddRookMoves(pieceList[Piece::PieceIndexRook][i], generationType, moves, moveCount);
+			}
+
+			for (int i = 0; i < pieceCount[Piece::PieceIndexQueen]; ++i)
+			{
+				AddQueenMoves(pieceList[Piece::PieceIndexQueen][i], generationType, moves, moveCount);
+			}
+
+			if (checkCount != 0 || pinnedCount != 0 || g_state.EnpassantTargetSquare != Null0x88Square)
+			{
+				int legalCount = 0;
+				for (int i = 0; i < moveCount; ++i)
+				{
+					const Move& move = moves[i];
+					const BoardIndex0x88 from = move.GetMoveFrom();
+					const BoardIndex0x88 to = move.GetMoveTo();
+
+					bool isLegal = true;
+
+					if (move.IsEnpassant())
+					{
+						//Two pawns leave the rank so the pin tests do not cover it. Rare so
+						//simply make the move and test.
+						isLegal = MakeMove<Us>(move);
+						if (isLegal) UnMakeMove();
+					}
+					else
+					{
+						for (int j = 0; j < pinnedCount; ++j)
+						{
+							if (pinnedSquares[j] == from)
+							{
+								isLegal = IsOnPinLine(from, to, pinDirections[j]);
+								break;
+							}
+						}
+
+						if (isLegal && checkCount != 0)
+						{
+							//Must capture the checking piece or block
+							isLegal = false;
+							for (int j = 0; j < checkBlockCount; ++j)
+							{
+								if (checkBlockSquares[j] == to)
+								{
+									isLegal = true;
+									break;
+								}
+							}
+						}
+					}
+
+					if (isLegal)
+					{
+						moves[legalCount] = move;
+						++legalCount;
+					}
+				}
+				moveCount = legalCount;
+			}
+		}
+
+		AddLegalKingMoves<Us>(kingSquare, checkCount != 0, moves, moveCount);
+	}
+
+	int Board::CountLegalMoves()
+	{
+		if (g_state.ColourToMove == Piece::PieceColourWhite)
+		{
+			return CountLegalMoves<Piece::PieceColourWhite>();
+		}
+
+		return CountLegalMoves<Piece::PieceColourBlack>();
+	}
+
+	template <int Us>
+	int Board::CountLegalMoves()
+	{
+		constexpr bool isWhite = Us == Piece::PieceColourWhite;
+		constexpr int them = Piece::OtherColour(Us);
+		constexpr int colourIndex = Piece::ColourToIndex(Us);
+
+		const BoardIndex0x88 kingSquare = GetKingSquare<Us>();
+
+		BoardIndex0x88 checkBlockSquares[MaxCheckBlockSquares];
+		int checkBlockCount = 0;
+		BoardIndex0x88 pinnedSquares[MaxPinnedPieces];
+		int pinDirections[MaxPinnedPieces];
+		int pinnedCount = 0;
+
+		const int checkCount = FindChecksAndPins<Us>(kingSquare, checkBlockSquares, checkBlockCount, pinnedSquares, pinDirections, pinnedCount);
+
+		Move kingMoves[MaxKingMoves];
+		int moveCount = 0;
+		AddLegalKingMoves<Us>(kingSquare, checkCount != 0, kingMoves, moveCount);
+
+		//Only the king can move out of double check
+		if (checkCount >= 2) return moveCount;
+
+		const CompactBoardIndex0x88(&pieceList)[Piece::PieceTypeCount][MaxPiecesPerType] = g_pieceList[colourIndex];
+		const int(&pieceCount)[Piece::PieceTypeCount] = g_pieceCount[colourIndex];
+
+		//The squares a move can end on. Any square without an own piece, or when in check
+		//the squares that capture the checking piece or block it.
+		Bitboard targets = 0;
+		if (checkCount == 0)
+		{
+			targets = ~g_colourBitboards[colourIndex];
+		}
+		else
+		{
+			for (int i = 0; i < checkBlockCount; ++i)
+			{
+				targets |= SquareBitboard(Sq0x88To64(checkBlockSquares[i]));
+			}
+		}
+
+		Bitboard pinned = 0;
+		for (int i = 0; i < pinnedCount; ++i)
+		{
+			pinned |= SquareBitboard(Sq0x88To64(pinnedSquares[i]));
+		}
+
+		//Knights, bishops, rooks and queens attack exactly the squares they can move to, so
+		//the unpinned ones' moves are their attacks on the target squares
+		const Bitboard occupancy = g_colourBitboards[Piece::ColourIndexWhite] | g_colourBitboards[Piece::ColourIndexBlack];
+		for (int pieceIndex = Piece::PieceIndexRook; pieceIndex <= Piece::PieceIndexQueen; ++pieceIndex)
+		{
+			for (int i = 0; i < pieceCount[pieceIndex]; ++i)
+			{
+				const BoardIndex64 sq64 = Sq0x88To64(pieceList[pieceIndex][i]);
+				if ((pinned & SquareBitboard(sq64)) != 0) continue;
+
+				Bitboard attacks;
+				switch (pieceIndex)
+				{
+				case Piece::PieceIndexKnight:
+					attacks = BitboardAttacks::GetKnightAttacks(sq64);
+					break;
+				case Piece::PieceIndexBishop:
+					attacks = BitboardAttacks::GetBishopAttacks(sq64, occupancy);
+					break;
+				case Piece::PieceIndexRook:
+					attacks = BitboardAttacks::GetRookAttacks(sq64, occupancy);
+					break;
+				default:
+					attacks = BitboardAttacks::GetQueenAttacks(sq64, occupancy);
+					break;
+				}
+
+				moveCount += PopCount(attacks & targets);
+			}
+		}
+
+		//A pinned piece cannot capture or block a checking piece, when not in check a pinned
+		//slider can move along the pin line up to and including the pinning piece
+		if (checkCount == 0)
+		{
+			for (int i = 0; i < pinnedCount; ++i)
+			{
+				const BoardIndex0x88 pinnedSquare = pinnedSquares[i];
+				const int pieceType = Piece::GetPackedType(g_board[pinnedSquare]);
+				const int direction = pinDirections[i];
+				if (pieceType == Piece::PieceTypePawn ||
+					(g_attackDeltaPieces[direction + AttackDeltaOffset] & pieceType) == 0) continue;
+
+				for (BoardIndex0x88 target = kingSquare + direction; ; target += direction)
+				{
+					if (target == pinnedSquare) continue;
+					++moveCount;
+					if (g_board[target] != Piece::PackedPieceNone) break;
+				}
+			}
+		}
+
+		//Pawns
+		constexpr int pawnAdvance = isWhite ? BoardDirPawnAdvanceSingleWhite : BoardDirPawnAdvanceSingleBlack;
+		constexpr int captureLeft = isWhite ? BoardDirPawnCaptureLeftWhite : BoardDirPawnCaptureLeftBlack;
+		constexpr int captureRight = isWhite ? BoardDirPawnCaptureRightWhite : BoardDirPawnCaptureRightBlack;
+		constexpr int homeRank = isWhite ? 0x10 : 0x60;
+
+		for (int i = 0; i < pieceCount[Piece::PieceIndexPawn]; ++i)
+		{
+			const BoardIndex0x88 start = pieceList[Piece::PieceIndexPawn][i];
+
+			int pinDirection = 0;
+			if ((pinned & SquareBitboard(Sq0x88To64(start))) != 0)
+			{
+				if (checkCount != 0) continue;
+				for (int j = 0; j < pinnedCount; ++j)
+				{
+					if (pinnedSquares[j] == start) pinDirection = pinDirections[j];
+				}
+			}
+
+			//Each promotion is four moves
+			const int movesPerTarget = ((start + pawnAdvance) & 0x70) == GetPromotionRank<Us>() ? 4 : 1;
+
+			const BoardIndex0x88 single = start + pawnAdvance;
+			if (g_board[single] == Piece::PackedPieceNone)
+			{
+				const bool isSingleOnPinLine = pinDirection == 0 || IsOnPinLine(start, single, pinDirection);
+				if (isSingleOnPinLine && (targets & SquareBitboard(Sq0x88To64(single))) != 0) moveCount += movesPerTarget;
+
+				const BoardIndex0x88 doublePush = single + pawnAdvance;
+				if ((start & 0x70) == homeRank &&
+					isSingleOnPinLine &&
+					g_board[doublePush] == Piece::PackedPieceNone &&
+					(targets & SquareBitboard(Sq0x88To64(doublePush))) != 0) ++moveCount;
+			}
+
+			const BoardIndex0x88 left = start + captureLeft;
+			if (Is0x88SquareValid(left) &&
+				(g_board[left] & them) != 0 &&
+				(targets & SquareBitboard(Sq0x88To64(left))) != 0 &&
+				(pinDirection == 0 || IsOnPinLine(start, left, pinDirection))) moveCount += movesPerTarget;
+
+			const BoardIndex0x88 right = start + captureRight;
+			if (Is0x88SquareValid(right) &&
+				(g_board[right] & them) != 0 &&
+				(targets & SquareBitboard(Sq0x88To64(right))) != 0 &&
+				(pinDirection == 0 || IsOnPinLine(start, right, pinDirection))) moveCount += movesPerTarget;
+		}
+
+		//Enpassant. Two pawns leave the rank so the pin tests do not cover it, rare so make the move and test.
+		if (g_state.EnpassantTargetSquare != Null0x88Square)
+		{
+			constexpr PackedPiece ownPawn = Piece::Pack(Piece::PieceTypePawn, Us);
+			const BoardIndex0x88 target = g_state.EnpassantTargetSquare;
+
+			BoardIndex0x88 start = target - captureLeft;
+			if (Is0x88SquareValid(start) && g_board[start] == ownPawn && MakeMove<Us>(Move(start, target, Move::MoveFlagEnpassant)))
+			{
+				UnMakeMove();
+				++moveCount;
+			}
+
+			start = target - captureRight;
+			if (Is0x88SquareValid(start) && g_board[start] == ownPawn && MakeMove<Us>(Move(start, target, Move::MoveFlagEnpassant)))
+			{
+				UnMakeMove();
+				++moveCount;
+			}
+		}
+
+		return moveCount;
+	}
+
+	bool Board::IsPseudoLegal(const Move& move) const
+	{
+		if (move.IsNull()) return false;
+
+		const BoardIndex0x88 from = move.GetMoveFrom();
+		const BoardIndex0x88 to = move.GetMoveTo();
+		const int us = g_state.ColourToMove;
+		const int them = Piece::OtherColour(us);
+		const bool isWhite = us == Piece::PieceColourWhite;
+
+		const PackedPiece piece = g_board[from];
+		const PackedPiece target = g_board[to];
+		if (Piece::GetPackedColour(piece) != us) return false;
+
+		const int pieceType = Piece::GetPackedType(piece);
+		const int pawnAdvance = isWhite ? BoardDirPawnAdvanceSingleWhite : BoardDirPawnAdvanceSingleBlack;
+		const bool isOnPromotionRank = (to & 0x70) == (isWhite ? GetPromotionRank<Piece::PieceColourWhite>() : GetPromotionRank<Piece::PieceColourBlack>());
+
+		//The attackers of a square are the pieces that can move to it, apart from pawns
+		const bool isAttacked = (GetAttackers(to, us) & SquareBitboard(Sq0x88To64(from))) != 0;
+
+		switch (move.GetFlags())
+		{
+		case Move::MoveFlagQuiet:
+			if (target != Piece::PackedPieceNone) return false;
+			if (pieceType == Piece::PieceTypePawn) return to == from + pawnAdvance && !isOnPromotionRank;
+			return isAttacked;
+
+		case Move::MoveFlagCapture:
+			if (Piece::GetPackedColour(target) != them) return false;
+			if (pieceType == Piece::PieceTypePawn && isOnPromotionRank) return false;
+			return isAttacked;
+
+		case Move::MoveFlagDoublePawnPush:
+			return pieceType == Piece::PieceTypePawn &&
+				(from & 0x70) == (isWhite ? 0x10 : 0x60) &&
+				to == from + pawnAdvance * 2 &&
+				g_board[from + pawnAdvance] == Piece::PackedPieceNone &&
+				target == Piece::PackedPieceNone;
+
+		case Move::MoveFlagEnpassant:
+			return pieceType == Piece::PieceTypePawn && to == g_state.EnpassantTargetSquare && isAttacked;
+
+		case Move::MoveFlagKingSideCastle:
+			return pieceType == Piece::PieceTypeKing &&
+				from == (isWhite ? 0x04 : 0x74) &&
+				to == from + 2 &&
+				(g_state.CastlingRights & (isWhite ? BoardState::CastleWhiteKingSide : BoardState::CastleBlackKingSide)) != 0 &&
+				g_board[from + 1] == Piece::PackedPieceNone &&
+				target == Piece::PackedPieceNone;
+
+		case Move::MoveFlagQueenSideCastle:
+			return pieceType == Piece::PieceTypeKing &&
+				from == (isWhite ? 0x04 : 0x74) &&
+				to == from - 2 &&
+				(g_state.CastlingRights & (isWhite ? BoardState::CastleWhiteQueenSide : BoardState::CastleBlackQueenSide)) != 0 &&
+				g_board[from - 1] == Piece::PackedPieceNone &&
+				target == Piece::PackedPieceNone &&
+				g_board[from - 3] == Piece::PackedPieceNone;
+
+		default:
+			//Promotions, with or without a capture. Anything else is not a valid flag.
+			if (!move.IsPromotion() || pieceType != Piece::PieceTypePawn || !isOnPromotionRank) return false;
+			if (move.IsCapture()) return Piece::GetPackedColour(target) == them && isAttacked;
+			return to == from + pawnAdvance && target == Piece::PackedPieceNone;
+		}
+	}
+
+	bool Board::GivesCheck(const Move& move) const
+	{
+		static constexpr int sliders = Piece::PieceTypeRook | Piece::PieceTypeBishop | Piece::PieceTypeQueen;
+
+		const int us = g_state.ColourToMove;
+		const BoardIndex0x88 kingSquare = us == Piece::PieceColourWhite ? g_state.BlackKingLocation0x88 : g_state.WhiteKingLocation0x88;
+		const BoardIndex0x88 moveFrom = move.GetMoveFrom();
+		const BoardIndex0x88 moveTo = move.GetMoveTo();
+		const BoardIndex0x88 secondaryMoveTo = move.GetSecondaryMoveTo();
+
+		//Direct check by the moved piece (the promoted piece when promoting), then by the rook when castling
+		BoardIndex0x88 checkerSquare = moveTo;
+		int checkerType = move.IsPromotion() ? move.GetPromoteTo() : Piece::GetPackedType(g_board[moveFrom]);
+		for (int i = 0; i < 2; ++i)
+		{
+			const int delta = static_cast<int>(kingSquare) - static_cast<int>(checkerSquare) + AttackDeltaOffset;
+			const int pieces = g_attackDeltaPieces[delta];
+
+			if ((pieces & checkerType) != 0)
+			{
+				switch (checkerType)
+				{
+				case Piece::PieceTypePawn:
+					if ((pieces & us) != 0) return true;
+					break;
+				case Piece::PieceTypeKnight:
+					return true;
+				case Piece::PieceTypeKing:
+					break; //Kings cannot give check
+				default:
+					if (FindFirstPieceAfterMove(checkerSquare, g_attackDeltaSteps[delta], move) == kingSquare) return true;
+					break;
+				}
+			}
+
+			if (secondaryMoveTo == Null0x88Square) break;
+			checkerSquare = secondaryMoveTo;
+			checkerType = Piece::PieceTypeRook;
+		}
+
+		//Discovered check by a slider behind a square the move empties
+		const BoardIndex0x88 vacatedSquares[2] = { moveFrom, move.GetOtherSquareToClear() };
+		for (int i = 0; i < 2; ++i)
+		{
+			const BoardIndex0x88 vacated = vacatedSquares[i];
+			if (vacated == Null0x88Square) continue;
+
+			const int step = GetAttackStep(kingSquare, vacated);
+			if (step == 0) continue;
+
+			const BoardIndex0x88 square = FindFirstPieceAfterMove(kingSquare, step, move);
+			if (square == Null0x88Square || square == moveTo || square == secondaryMoveTo) continue; //Moved pieces are tested above
+
+			const PackedPiece piece = g_board[square];
+			const int pieceType = Piece::GetPackedType(piece);
+			if (Piece::GetPackedColour(piece) == us &&
+				(pieceType & sliders) != 0 &&
+				(g_attackDeltaPieces[static_cast<int>(kingSquare) - static_cast<int>(square) + AttackDeltaOffset] & pieceType) != 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	int Board::SEE(const Move& move) const
+	{
+		const BoardIndex0x88 to = move.GetMoveTo();
+		const BoardIndex0x88 from = move.GetMoveFrom();
+
+		//gains[i] is the material won by the side making the ith capture if the sequence stopped there
+		int gains[32];
+		int depth = 0;
+		gains[0] = GetSeeCaptureValue(move);
+
+		Bitboard attackers = GetAttackers(to, Piece::PieceColourWhite) | GetAttackers(to, Piece::PieceColourBlack);
+		Bitboard removed = 0;
+		RemoveSeeAttacker(to, from, attackers, removed);
+		if (move.IsEnpassant()) RemoveSeeAttacker(to, move.GetOtherSquareToClear(), attackers, removed);
+
+		//The value of the piece now standing on the target square
+		int onTargetValue = Piece::GetPieceValue(move.IsPromotion() ? move.GetPromoteTo() : Piece::GetPackedType(g_board[from]));
+		int colour = Piece::OtherColour(g_state.ColourToMove);
+
+		while (depth < 31)
+		{
+			const BoardIndex0x88 square = GetLeastValuableAttacker(attackers, colour);
+			if (square == Null0x88Square) break;
+
+			++depth;
+			gains[depth] = onTargetValue - gains[depth - 1];
+
+			RemoveSeeAttacker(to, square, attackers, removed);
+			onTargetValue = Piece::GetPieceValue(Piece::GetPackedType(g_board[square]));
+			colour = Piece::OtherColour(colour);
+		}
+
+		//Each side may choose not to capture
+		while (depth > 0)
+		{
+			if (gains[depth] > -gains[depth - 1]) gains[depth - 1] = -gains[depth];
+			--depth;
+		}
+
+		return gains[0];
+	}
+
+	bool Board::SeeGreaterOrEqual(const Move& move, const int threshold) const
+	{
+		const BoardIndex0x88 to = move.GetMoveTo();
+		const BoardIndex0x88 from = move.GetMoveFrom();
+
+		//Best case, the capture is not answered
+		int balance = GetSeeCaptureValue(move) - threshold;
+		if (balance < 0) return false;
+
+		//Worst case, the capturing piece is lost for nothing more
+		const int movedValue = Piece::GetPieceValue(move.IsPromotion() ? move.GetPromoteTo() : Piece::GetPackedType(g_board[from]));
+		balance -= movedValue;
+		if (balance >= 0) return true;
+
+		Bitboard attackers = GetAttackers(to, Piece::PieceColourWhite) | GetAttackers(to, Piece::PieceColourBlack);
+		Bitboard removed = 0;
+		RemoveSeeAttacker(to, from, attackers, removed);
+		if (move.IsEnpassant()) RemoveSeeAttacker(to, move.GetOtherSquareToClear(), attackers, removed);
+
+		//colour is the side to capture next. balance is from the view of the other side, which made
+		//the last capture, assuming the piece it captured with is lost. It is negative here.
+		const int us = g_state.ColourToMove;
+		int colour = Piece::OtherColour(us);
+		while (true)
+		{
+			const BoardIndex0x88 square = GetLeastValuableAttacker(attackers, colour);
+
+			//Cannot recapture so loses the exchange
+			if (square == Null0x88Square) return colour != us;
+
+			RemoveSeeAttacker(to, square, attackers, removed);
+			const int pieceType = Piece::GetPackedType(g_board[square]);
+
+			//Negamax with a null window, (balance, balance + 1) becomes (-balance - 1, -balance)
+			balance = -balance - 1 - Piece::GetPieceValue(pieceType);
+
+			if (balance >= 0)
+			{
+				//Wins even if the capturing piece is lost, unless it is a king capturing onto an attacked square
+				if (pieceType == Piece::PieceTypeKing && GetLeastValuableAttacker(attackers, Piece::OtherColour(colour)) != Null0x88Square)
+				{
+					return colour != us;
+				}
+				return colour == us;
+			}
+
+			colour = Piece::OtherColour(colour);
+		}
+	}
+
+	int Board::GetSeeCaptureValue(const Move& move) const
+	{
+		int value = move.IsEnpassant() ? Piece::GetPieceValue(Piece::PieceTypePawn) : Piece::GetPieceValue(Piece::GetPackedType(g_board[move.GetMoveTo()]));
+		if (move.IsPromotion())
+		{
+			value += Piece::GetPieceValue(move.GetPromoteTo()) - Piece::GetPieceValue(Piece::PieceTypePawn);
+		}
+		return value;
+	}
+
+	void Board::RemoveSeeAttacker(const BoardIndex0x88 target, const BoardIndex0x88 square, Bitboard& attackers, Bitboard& removed) const
+	{
+		attackers &= ~SquareBitboard(Sq0x88To64(square));
+		removed |= SquareBitboard(Sq0x88To64(square));
+
+		//X-ray, the first piece further along the line from the target may be a slider that now attacks it
+		const int step = GetAttackStep(target, square);
+		if (step == 0) return;
+
+		for (BoardIndex0x88 behind = square + step; Is0x88SquareValid(behind); behind += step)
+		{
+			const PackedPiece piece = g_board[behind];
+			if (piece == Piece::PackedPieceNone || (removed & SquareBitboard(Sq0x88To64(behind))) != 0) continue;
+
+			const int pieceType = Piece::GetPackedType(piece);
+			if ((pieceType & (Piece::PieceTypeRook | Piece::PieceTypeBishop | Piece::PieceTypeQueen)) != 0 &&
+				(g_attackDeltaPieces[static_cast<int>(target) - static_cast<int>(behind) + AttackDeltaOffset] & pieceType) != 0)
+			{
+				attackers |= SquareBitboard(Sq0x88To64(behind));
+			}
+			return;
+		}
+	}
+
+	BoardIndex0x88 Board::GetLeastValuableAttacker(const Bitboard attackers, const int colour) const
+	{
+		BoardIndex0x88 leastValuable = Null0x88Square;
+		int leastValue = 0;
+
+		Bitboard remaining = attackers;
+		while (remaining != 0)
+		{
+			const BoardIndex0x88 square = Sq64To0x88(PopLeastSignificantSquare(remaining));
+			const PackedPiece piece = g_board[square];
+			if (Piece::GetPackedColour(piece) != colour) continue;
+
+			const int value = Piece::GetPieceValue(Piece::GetPackedType(piece));
+			if (leastValuable == Null0x88Square || value < leastValue)
+			{
+				leastValuable = square;
+				leastValue = value;
+			}
+		}
+
+		return leastValuable;
+	}
+
+	BoardIndex0x88 Board::FindFirstPieceAfterMove(const BoardIndex0x88 start, const int step, const Move& move) const
+	{
+		const BoardIndex0x88 moveFrom = move.GetMoveFrom();
+		const BoardIndex0x88 moveTo = move.GetMoveTo();
+		const BoardIndex0x88 secondaryMoveFrom = move.GetSecondaryMoveFrom();
+		const BoardIndex0x88 secondaryMoveTo = move.GetSecondaryMoveTo();
+		const BoardIndex0x88 otherSquareToClear = move.GetOtherSquareToClear();
+
+		for (BoardIndex0x88 square = start + step; Is0x88SquareValid(square); square += step)
+		{
+			if (square == moveTo || square == secondaryMoveTo) return square;
+			if (square == moveFrom || square == secondaryMoveFrom || square == otherSquareToClear) continue;
+			if (g_board[square] != Piece::PackedPieceNone) return square;
+		}
+
+		return Null0x88Square;
+	}
+
+	template <int Us>
+	int Board::FindChecksAndPins(
+		const BoardIndex0x88 kingSquare,
+		BoardIndex0x88* checkBlockSquares,
+		int& checkBlockCount,
+		BoardIndex0x88* pinnedSquares,
+		int* pinDirections,
+		int& pinnedCount)
+	{
+		static constexpr int directions[8] = {
+			BoardDirUp, BoardDirDown, BoardDirRight, BoardDirLeft,
+			BoardDirUpRight, BoardDirDownLeft, BoardDirUpLeft, BoardDirDownRight };
+		static constexpr int knightDirections[8] = {
+			BoardDirKnight1, BoardDirKnight2, BoardDirKnight3, BoardDirKnight4,
+			BoardDirKnight5, BoardDirKnight6, BoardDirKnight7, BoardDirKnight8 };
+
+		constexpr int us = Us;
+		constexpr int them = Piece::OtherColour(Us);
+
+		int checkCount = 0;
+		checkBlockCount = 0;
+		pinnedCount = 0;
+
+		//Sliders
+		for (int i = 0; i < 8; ++i)
+		{
+			const int direction = directions[i];
+			//The first 4 directions are straight, the rest diagonal
+			const int sliderType = i < 4 ? Piece::PieceTypeRook : Piece::PieceTypeBishop;
+
+			BoardIndex0x88 ownPieceSquare = Null0x88Square;
+			BoardIndex0x88 target = kingSquare + direction;
+			while (Is0x88SquareValid(target))
+			{
+				const PackedPiece piece = g_board[target];
+				if (piece != Piece::PackedPieceNone)
+				{
+					if ((piece & us) != 0)
+					{
+						//Own piece, a second one means there is no pin in this direction
+						if (ownPieceSquare != Null0x88Square) break;
+						ownPieceSquare = target;
+					}
+					else
+					{
+						const int pieceType = Piece::GetPackedType(piece);
+						if (pieceType == Piece::PieceTypeQueen || pieceType == sliderType)
+						{
+							if (ownPieceSquare == Null0x88Square)
+							{
+								//Check, every square from the king up to the checker resolves it
+								++checkCount;
+								checkBlockCount = 0;
+								for (BoardIndex0x88 sq = kingSquare + direction; sq != target; sq += direction)
+								{
+									checkBlockSquares[checkBlockCount] = sq;
+									++checkBlockCount;
+								}
+								checkBlockSquares[checkBlockCount] = target;
+								++checkBlockCount;
+							}
+							else
+							{
+								pinnedSquares[pinnedCount] = ownPieceSquare;
+								pinDirections[pinnedCount] = direction;
+								++pinnedCount;
+							}
+						}
 						break;
 					}
 				}
+				target += direction;
+			}
+		}
+
+		//Knights
+		const PackedPiece enemyKnight = Piece::Pack(Piece::PieceTypeKnight, them);
+		for (int i = 0; i < 8; ++i)
+		{
+			BoardIndex0x88 target = kingSquare + knightDirections[i];
+			if (Is0x88SquareValid(target) && g_board[target] == enemyKnight)
+			{
+				++checkCount;
+				checkBlockSquares[0] = target;
+				checkBlockCount = 1;
 			}
 		}
+
+		//Pawns
+		const PackedPiece enemyPawn = Piece::Pack(Piece::PieceTypePawn, them);
+		const int pawnDirection1 = them == Piece::PieceColourWhite ? BoardDirTowardsAttackingWhitePawn1 : BoardDirTowardsAttackingBlackPawn1;
+		const int pawnDirection2 = them == Piece::PieceColourWhite ? BoardDirTowardsAttackingWhitePawn2 : BoardDirTowardsAttackingBlackPawn2;
+
+		BoardIndex0x88 target = kingSquare + pawnDirection1;
+		if (Is0x88SquareValid(target) && g_board[target] == enemyPawn)
+		{
+			++checkCount;
+			checkBlockSquares[0] = target;
+			checkBlockCount = 1;
+		}
+
+		target = kingSquare + pawnDirection2;
+		if (Is0x88SquareValid(target) && g_board[target] == enemyPawn)
+		{
+			++checkCount;
+			checkBlockSquares[0] = target;
+			checkBlockCount = 1;
+		}
+
+		return checkCount;
 	}
 
+	template <int Us>
+	void Board::AddLegalKingMoves(const BoardIndex0x88 kingSquare, bool isInCheck, Move* moves, int& moveCount)
+	{
+		static constexpr int directions[8] = {
+			BoardDirUp, BoardDirDown, BoardDirRight, BoardDirLeft,
+			BoardDirUpRight, BoardDirDownLeft, BoardDirUpLeft, BoardDirDownRight };
+
+		constexpr int us = Us;
+		constexpr int them = Piece::OtherColour(Us);
+
+		//Lift the king so sliders attack through its square (it cannot step back along a checking ray)
+		const PackedPiece king = g_board[kingSquare];
+		g_board[kingSquare] = Piece::PackedPieceNone;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			BoardIndex0x88 target = kingSquare + directions[i];
+			if (!Is0x88SquareValid(target)) continue;
+
+			const PackedPiece piece = g_board[target];
+			if ((piece & us) != 0) continue;
+
+			if (!IsSquareAttackedScan(target, them))
+			{
+				AddMove(
+					kingSquare,
+					target,
+					piece == Piece::PackedPieceNone ? Move::MoveFlagQuiet : Move::MoveFlagCapture,
+					moves,
+					moveCount);
+			}
+		}
+
+		g_board[kingSquare] = king;
+
+		//Castling. Castling rights mean the king and rook are in place.
+		if (isInCheck) return;
+
+		constexpr unsigned int kingSide = us == Piece::PieceColourWhite ? BoardState::CastleWhiteKingSide : BoardState::CastleBlackKingSide;
+		constexpr unsigned int queenSide = us == Piece::PieceColourWhite ? BoardState::CastleWhiteQueenSide : BoardState::CastleBlackQueenSide;
+
+		if ((g_state.CastlingRights & kingSide) != 0 &&
+			g_board[kingSquare + 1] == Piece::PackedPieceNone &&
+			g_board[kingSquare + 2] == Piece::PackedPieceNone &&
+			!IsSquareAttacked(kingSquare + 1, them) &&
+			!IsSquareAttacked(kingSquare + 2, them))
+		{
+			AddMove(kingSquare, kingSquare + 2, Move::MoveFlagKingSideCastle, moves, moveCount);
+		}
+
+		if ((g_state.CastlingRights & queenSide) != 0 &&
+			g_board[kingSquare - 1] == Piece::PackedPieceNone &&
+			g_board[kingSquare - 2] == Piece::PackedPieceNone &&
+			g_board[kingSquare - 3] == Piece::PackedPieceNone &&
+			!IsSquareAttacked(kingSquare - 1, them) &&
+			!IsSquareAttacked(kingSquare - 2, them))
+		{
+			AddMove(kingSquare, kingSquare - 2, Move::MoveFlagQueenSideCastle, moves, moveCount);
+		}
+	}
+
+	template <int Us>
 	void Board::UpdateStateForMove(const Move& move)
 	{
-		int pieceType = g_board[move.MoveFrom].PieceType;
-		int capturePieceType = g_board[move.MoveTo].PieceType;
+		const BoardIndex0x88 moveFrom = move.GetMoveFrom();
+		const BoardIndex0x88 moveTo = move.GetMoveTo();
+
+		int pieceType = Piece::GetPackedType(g_board[moveFrom]);
+		int capturePieceType = Piece::GetPackedType(g_board[moveTo]);
 
-		g_EnpassantTargetSquare = { Null0x88Square };
+		g_state.EnpassantTargetSquare = { Null0x88Square };
 
 		bool resetHalfMoveClock = false;
 
@@ -125,35 +1222,33 @@ namespace ATHENAZEROENG
 			//1. Update King Position
 			//2. Update Whether Can Castle			
 
-			if (g_colourToMove == Piece::PieceColourWhite)
+			if (Us == Piece::PieceColourWhite)
 			{
-				g_WhiteKingLocation0x88 = move.MoveTo;
-				g_canWhiteCastleKingSide = { false };
-				g_canWhiteCastleQueenSide = { false };
+				g_state.WhiteKingLocation0x88 = moveTo;
+				g_state.CastlingRights &= ~(BoardState::CastleWhiteKingSide | BoardState::CastleWhiteQueenSide);
 			}
 			else
 			{
-				g_BlackKingLocation0x88 = move.MoveTo;
-				g_canBlackCastleKingSide = { false };
-				g_canBlackCastleQueenSide = { false };
+				g_state.BlackKingLocation0x88 = moveTo;
+				g_state.CastlingRights &= ~(BoardState::CastleBlackKingSide | BoardState::CastleBlackQueenSide);
 			}
 		}
 		else if (pieceType == Piece::PieceTypeRook)
 		{
 			//Rook moving, may affect castling
-			switch (move.MoveFrom)
+			switch (moveFrom)
 			{
 			case 0x07:
-				g_canWhiteCastleKingSide = { false };
+				g_state.CastlingRights &= ~BoardState::CastleWhiteKingSide;
 				break;
 			case 0x00:
-				g_canWhiteCastleQueenSide = { false };
+				g_state.CastlingRights &= ~BoardState::CastleWhiteQueenSide;
 				break;
 			case 0x77:
-				g_canBlackCastleKingSide = { false };
+				g_state.CastlingRights &= ~BoardState::CastleBlackKingSide;
 				break;
 			case 0x70:
-				g_canBlackCastleQueenSide = { false };
+				g_state.CastlingRights &= ~BoardState::CastleBlackQueenSide;
 				break;
 			}
 		}
@@ -161,488 +1256,689 @@ namespace ATHENAZEROENG
 		{
 			resetHalfMoveClock = true;
 
-			int diff = 0x77 + move.MoveFrom - move.MoveTo;
-			if (g_colourToMove == Piece::PieceColourWhite)
+			if (move.GetFlags() == Move::MoveFlagDoublePawnPush)
 			{
-				if (diff == 87)
-				{
-					//Double square move
-					g_EnpassantTargetSquare = move.MoveTo - 16;
-				}
+				//Double square move, target is the square passed over
+				g_state.EnpassantTargetSquare = (moveFrom + moveTo) / 2;
 			}
-			else
+		}
+
+		if (capturePieceType == Piece::PieceTypeRook)
+		{
+			if (moveTo == 0x07) g_state.CastlingRights &= ~BoardState::CastleWhiteKingSide; //Either captured black's King Side rook or the rook has moved anyway
+			if (moveTo == 0x00) g_state.CastlingRights &= ~BoardState::CastleWhiteQueenSide; //Either captured black's King Side rook or the rook has moved anyway
+			if (moveTo == 0x77) g_state.CastlingRights &= ~BoardState::CastleBlackKingSide; //Either captured white's Queen Side rook or the rook has moved anyway
+			if (moveTo == 0x70) g_state.CastlingRights &= ~BoardState::CastleBlackQueenSide; //Either captured white's Queen Side rook or the rook has moved anyway                
+		}
+
+		if (resetHalfMoveClock)
+		{
+			g_state.HalfMoveClock = { 0 };
+		}
+		else
+		{
+			++g_state.HalfMoveClock;
+		}
+
+		//Update side to move
+		if (Us == Piece::PieceColourBlack) ++g_state.FullMoveNumber;
+		g_state.ColourToMove = Piece::OtherColour(Us);
+	}
+
+	bool Board::MakeMove(const Move& move)
+	{
+		if (g_state.ColourToMove == Piece::PieceColourWhite)
+		{
+			return MakeMove<Piece::PieceColourWhite>(move);
+		}
+
+		return MakeMove<Piece::PieceColourBlack>(move);
+	}
+
+	template <int Us>
+	bool Board::MakeMove(const Move& move)
+	{
+		constexpr int them = Piece::OtherColour(Us);
+
+		if (!MakeLegalMove<Us>(move)) return false;
+
+		//The king location was updated by UpdateStateForMove
+		if (IsSquareAttacked(GetKingSquare<Us>(), them))
+		{
+			//Cannot move into or leave in check
+			UnMakeMove();
+			return false;
+		}
+
+		if (move.IsCastling())
+		{
+			if (IsSquareAttacked(move.GetMoveFrom(), them))
 			{
-				if (diff == 151)
-				{
-					//Double square move
-					g_EnpassantTargetSquare = move.MoveTo + 16;
-				}
+				//Cannot castle out of check
+				UnMakeMove();
+				return false;
+			}
+
+			//The square the king passes over is where the rook ends up
+			if (IsSquareAttacked(move.GetSecondaryMoveTo(), them))
+			{
+				//Cannot castle through check
+				UnMakeMove();
+				return false;
 			}
 		}
 
-		if (capturePieceType == Piece::PieceTypeRook)
+		return true;
+	}
+
+	bool Board::MakeLegalMove(const Move& move)
+	{
+		if (g_state.ColourToMove == Piece::PieceColourWhite)
 		{
-			if (move.MoveTo == 0x07) g_canWhiteCastleKingSide = { false }; //Either captured black's King Side rook or the rook has moved anyway
-			if (move.MoveTo == 0x00) g_canWhiteCastleQueenSide = { false }; //Either captured black's King Side rook or the rook has moved anyway
-			if (move.MoveTo == 0x77) g_canBlackCastleKingSide = { false }; //Either captured white's Queen Side rook or the rook has moved anyway
-			if (move.MoveTo == 0x70) g_canBlackCastleQueenSide = { false }; //Either captured white's Queen Side rook or the rook has moved anyway                
+			return MakeLegalMove<Piece::PieceColourWhite>(move);
 		}
 
-		if (resetHalfMoveClock)
+		return MakeLegalMove<Piece::PieceColourBlack>(move);
+	}
+
+	template <int Us>
+	bool Board::MakeLegalMove(const Move& move)
+	{
+		//The unmake stack is full, i.e. the game plus search path is too long
+		if (g_UnmakeLength == FixedUnmakeMoveListCapacity) return false;
+
+		//Squares derived from the packed move. Null0x88Square is a valid array index so can always be used.
+		const BoardIndex0x88 moveFrom = move.GetMoveFrom();
+		const BoardIndex0x88 moveTo = move.GetMoveTo();
+		const int promoteTo = move.GetPromoteTo();
+		const BoardIndex0x88 otherSquareToClear = move.GetOtherSquareToClear();
+		const BoardIndex0x88 secondaryMoveFrom = move.GetSecondaryMoveFrom();
+		const BoardIndex0x88 secondaryMoveTo = move.GetSecondaryMoveTo();
+
+		RecordStateToUnMake(move);
+
+		g_key ^= GetStateKey();
+		UpdateStateForMove<Us>(move);
+		g_key ^= GetStateKey() ^ Zobrist::GetBlackToMoveKey();
+
+		//Piece lists - Must be done while the board still holds the pieces being moved/captured
+		if (g_board[moveTo] != Piece::PackedPieceNone) RemoveFromPieceList(moveTo);
+		if (g_board[otherSquareToClear] != Piece::PackedPieceNone) RemoveFromPieceList(otherSquareToClear);
+		if (secondaryMoveFrom != Null0x88Square) MovePieceInList(secondaryMoveFrom, secondaryMoveTo);
+		if (promoteTo == Piece::PieceTypeNone)
 		{
-			g_halfMoveClock = { 0 };
+			MovePieceInList(moveFrom, moveTo);
 		}
 		else
 		{
-			++g_halfMoveClock;
+			RemoveFromPieceList(moveFrom);
 		}
 
-		//Update side to move
-		if (g_colourToMove == Piece::PieceColourWhite)
+		//Main piece
+		PackedPiece movedPiece = g_board[moveFrom];
+		if (promoteTo != Piece::PieceTypeNone)
 		{
-			g_colourToMove = Piece::PieceColourBlack;
+			movedPiece = Piece::Pack(promoteTo, Us);
+		}
+		g_key ^= GetPieceKey(g_board[moveFrom], moveFrom) ^ GetPieceKey(movedPiece, moveTo);
+		ClearPiece(moveFrom);
+		if (g_board[moveTo] == Piece::PackedPieceNone)
+		{
+			PlacePiece(moveTo, movedPiece);
 		}
 		else
 		{
-			++g_fullMoveNumber;
-			g_colourToMove = Piece::PieceColourWhite;
+			g_key ^= GetPieceKey(g_board[moveTo], moveTo);
+			ReplacePiece(moveTo, movedPiece);
 		}
-	}
-
-	bool Board::MakeMove(const Move& move)
-	{
-		if (!RecordStateToUnMake(move)) return false;
-		UpdateStateForMove(move);
 
-		//Remember g_colourToMove will now be the other player so is used in reverse below.
-		//         If white has just moved this will now indicate black is to move, and vice-versa.		
-
-		//Main piece
-		if (move.PromoteTo == Piece::PieceTypeNone)
+		//Enpassant
+		if (otherSquareToClear != Null0x88Square)
 		{
-			g_board[move.MoveTo].PieceType = g_board[move.MoveFrom].PieceType;
+			g_key ^= GetPieceKey(g_board[otherSquareToClear], otherSquareToClear);
+			ClearPiece(otherSquareToClear);
 		}
-		else
+
+		//Rook if castling
+		if (secondaryMoveFrom != Null0x88Square)
 		{
-			g_board[move.MoveTo].PieceType = move.PromoteTo;
+			const PackedPiece rook = g_board[secondaryMoveFrom];
+			g_key ^= GetPieceKey(rook, secondaryMoveFrom) ^ GetPieceKey(rook, secondaryMoveTo);
+			ClearPiece(secondaryMoveFrom);
+			PlacePiece(secondaryMoveTo, rook);
 		}
-		g_board[move.MoveTo].PieceColour = g_board[move.MoveFrom].PieceColour;
-		g_board[move.MoveFrom].PieceType = Piece::PieceTypeNone;
 
-		//Rook if castling
-		g_board[move.SecondaryMoveTo].PieceType = g_board[move.SecondaryMoveFrom].PieceType;
-		g_board[move.SecondaryMoveTo].PieceColour = g_board[move.SecondaryMoveFrom].PieceColour;
+		if (promoteTo != Piece::PieceTypeNone) AddToPieceList(moveTo);
 
-		//Enpassant
-		g_board[move.OtherSquareToClear].PieceType = Piece::PieceTypeNone;
+		return true;
+	}
 
-		g_board[move.SecondaryMoveFrom].PieceType = Piece::PieceTypeNone;
+	void Board::UnMakeMove()
+	{
+		--g_UnmakeLength;
+
+		const UnmakeItem& unmakeItem = g_UnmakeList[g_UnmakeLength];
 
-		//Check testing				
-		BoardIndex0x88 kingSideRookStartLocation;
-		BoardIndex0x88 queenSideRookStartLocation;
-		if (g_colourToMove == Piece::PieceColourWhite)
+		const Move move = unmakeItem.GetMoveMade();
+		const BoardIndex0x88 moveFrom = move.GetMoveFrom();
+		const BoardIndex0x88 moveTo = move.GetMoveTo();
+		const BoardIndex0x88 secondaryMoveFrom = move.GetSecondaryMoveFrom();
+		const BoardIndex0x88 secondaryMoveTo = move.GetSecondaryMoveTo();
+		const bool isPromotion = move.IsPromotion();
+
+		//The side that made the move and the piece it moved (a pawn if it promoted)
+		const int movedColour = Piece::OtherColour(g_state.ColourToMove);
+		const PackedPiece originalPiece = isPromotion ? Piece::Pack(Piece::PieceTypePawn, movedColour) : g_board[moveTo];
+
+		//For enpassant the captured piece goes back on the other square, the to square is left empty
+		BoardIndex0x88 capturedSquare = moveTo;
+		if (move.IsEnpassant())
 		{
-			//Black moving (and white attacking) - Remember side to move is now reversed
-			kingSideRookStartLocation = 0x77;
-			queenSideRookStartLocation = 0x70;
+			capturedSquare = move.GetOtherSquareToClear();
+		}
 
-			//g_BlackKingLocation0x88 was updated by UpdateStateForMove
-			if (IsSquareAttacked(g_BlackKingLocation0x88, g_colourToMove))
-			{
-				//Cannot move into or leave in check
-				UnMakeMove();
-				return false;
-			}
+		// *** Piece Lists *** \\
+
+		//Pieces that moved are moved back before the board is restored
+		if (secondaryMoveFrom != Null0x88Square) MovePieceInList(secondaryMoveTo, secondaryMoveFrom);
+		if (isPromotion)
+		{
+			RemoveFromPieceList(moveTo);
 		}
 		else
 		{
-			//White moving (and black attacking) - Remember side to move is now reversed
-			kingSideRookStartLocation = 0x07;
-			queenSideRookStartLocation = 0x00;
+			MovePieceInList(moveTo, moveFrom);
+		}
 
-			//g_WhiteKingLocation0x88 was updated by UpdateStateForMove
-			if (IsSquareAttacked(g_WhiteKingLocation0x88, g_colourToMove))
-			{
-				//Cannot move into or leave in check
-				UnMakeMove();
-				return false;
-			}
+		// *** Move *** \\
+		
+		if (secondaryMoveFrom != Null0x88Square)
+		{
+			const PackedPiece rook = g_board[secondaryMoveTo];
+			ClearPiece(secondaryMoveTo);
+			PlacePiece(secondaryMoveFrom, rook);
 		}
 
-		bool isCastling = (move.SecondaryMoveFrom != Null0x88Square);
-		if (isCastling)
+		if (capturedSquare == moveTo && unmakeItem.CapturedPiece != Piece::PackedPieceNone)
 		{
-			if (IsSquareAttacked(move.MoveFrom, g_colourToMove)) //g_colourToMove has been reversed!
-			{
-				//Cannot castle out of check
-				UnMakeMove();
-				return false;
-			}
+			ReplacePiece(moveTo, unmakeItem.CapturedPiece);
+		}
+		else
+		{
+			ClearPiece(moveTo);
+		}
+
+		PlacePiece(moveFrom, originalPiece);
+
+		if (capturedSquare != moveTo) PlacePiece(capturedSquare, unmakeItem.CapturedPiece);
 
-			if (move.SecondaryMoveFrom == kingSideRookStartLocation)
+		//Pieces that were removed are added back after the board is restored
+		if (isPromotion) AddToPieceList(moveFrom);
+		if (unmakeItem.CapturedPiece != Piece::PackedPieceNone) AddToPieceList(capturedSquare);
+
+		// *** State *** \\
+
+		//Reversible state is worked out from the move, the rest was recorded
+		g_state.ColourToMove = static_cast<unsigned char>(movedColour);
+		if (movedColour == Piece::PieceColourBlack) --g_state.FullMoveNumber;
+		if (Piece::GetPackedType(originalPiece) == Piece::PieceTypeKing)
+		{
+			if (movedColour == Piece::PieceColourWhite)
 			{
-				//King Side
-				//Check square one to the right, side to move is attacking!
-				if (IsSquareAttacked(move.MoveFrom + 1, g_colourToMove)) //g_colourToMove has been reversed!
-				{
-					//Cannot castle through check
-					UnMakeMove();
-					return false;
-				}
+				g_state.WhiteKingLocation0x88 = static_cast<CompactBoardIndex0x88>(moveFrom);
 			}
-			else if (move.SecondaryMoveFrom == queenSideRookStartLocation)
+			else
 			{
-				//Queen Side
-				//Check square one to the right, side to move is attacking!
-				if (IsSquareAttacked(move.MoveFrom - 1, g_colourToMove)) //g_colourToMove has been reversed!
-				{
-					//Cannot castle through check
-					UnMakeMove();
-					return false;
-				}
+				g_state.BlackKingLocation0x88 = static_cast<CompactBoardIndex0x88>(moveFrom);
 			}
 		}
 
-		return true;
+		g_state.CastlingRights = unmakeItem.CastlingRights;
+		g_state.EnpassantTargetSquare = unmakeItem.EnpassantTargetSquare;
+		g_state.HalfMoveClock = unmakeItem.HalfMoveClock;
+		g_key = unmakeItem.Key;
 	}
 
-	void Board::UnMakeMove()
+	bool Board::MakeNullMove()
 	{
-		--g_UnmakeLength;
+		if (g_UnmakeLength == FixedUnmakeMoveListCapacity) return false;
 
 		UnmakeItem& unmakeItem = g_UnmakeList[g_UnmakeLength];
+		unmakeItem.MoveData = Move().GetData();
+		unmakeItem.CapturedPiece = Piece::PackedPieceNone;
+		unmakeItem.HalfMoveClock = g_state.HalfMoveClock;
+		unmakeItem.CastlingRights = g_state.CastlingRights;
+		unmakeItem.EnpassantTargetSquare = g_state.EnpassantTargetSquare;
+		unmakeItem.Key = g_key;
+		++g_UnmakeLength;
 
-		// *** Move *** \\
-		
-		g_board[unmakeItem.MovedFrom].PieceColour = unmakeItem.OriginalPiece.PieceColour;
-		g_board[unmakeItem.MovedFrom].PieceType = unmakeItem.OriginalPiece.PieceType;
+		g_key ^= GetStateKey();
+		g_state.EnpassantTargetSquare = { Null0x88Square };
+		++g_state.HalfMoveClock;
+		if (g_state.ColourToMove == Piece::PieceColourBlack) ++g_state.FullMoveNumber;
+		g_state.ColourToMove = static_cast<unsigned char>(Piece::OtherColour(g_state.ColourToMove));
+		g_key ^= GetStateKey() ^ Zobrist::GetBlackToMoveKey();
 
-		g_board[unmakeItem.MovedTo].PieceColour = unmakeItem.CapturedPiece.PieceColour;
-		g_board[unmakeItem.MovedTo].PieceType = unmakeItem.CapturedPiece.PieceType;
+		return true;
+	}
 
-		g_board[unmakeItem.MovedFrom2].PieceColour = g_board[unmakeItem.MovedTo2].PieceColour;
-		g_board[unmakeItem.MovedFrom2].PieceType = g_board[unmakeItem.MovedTo2].PieceType;
+	void Board::UnMakeNullMove()
+	{
+		--g_UnmakeLength;
 
-		g_board[unmakeItem.MovedTo2].PieceType = Piece::PieceTypeNone;
+		const UnmakeItem& unmakeItem = g_UnmakeList[g_UnmakeLength];
 
-		g_board[unmakeItem.OtherReplaceSquare].PieceColour = unmakeItem.OtherReplacePiece.PieceColour;
-		g_board[unmakeItem.OtherReplaceSquare].PieceType = unmakeItem.OtherReplacePiece.PieceType;
+		g_state.ColourToMove = static_cast<unsigned char>(Piece::OtherColour(g_state.ColourToMove));
+		if (g_state.ColourToMove == Piece::PieceColourBlack) --g_state.FullMoveNumber;
+		g_state.EnpassantTargetSquare = unmakeItem.EnpassantTargetSquare;
+		g_state.HalfMoveClock = unmakeItem.HalfMoveClock;
+		g_key = unmakeItem.Key;
+	}
 
-		// *** State *** \\
+	bool Board::IsRepetition() const
+	{
+		//Only positions since the last capture or pawn move can repeat
+		const size_t halfMoveClock = g_state.HalfMoveClock;
+		const size_t limit = halfMoveClock < g_UnmakeLength ? halfMoveClock : g_UnmakeLength;
 
-		g_colourToMove = unmakeItem.ColourToMove;
-		g_canWhiteCastleKingSide = unmakeItem.CanWhiteCastleKingSide;
-		g_canWhiteCastleQueenSide = unmakeItem.CanWhiteCastleQueenSide;
-		g_canBlackCastleKingSide = unmakeItem.CanBlackCastleKingSide;
-		g_canBlackCastleQueenSide = unmakeItem.CanBlackCastleQueenSide;
-		g_WhiteKingLocation0x88 = unmakeItem.WhiteKingLocation0x88;
-		g_BlackKingLocation0x88 = unmakeItem.BlackKingLocation0x88;
-		g_EnpassantTargetSquare = unmakeItem.EnpassantTargetSquare;
-		g_halfMoveClock = unmakeItem.HalfMoveClock;
-		g_fullMoveNumber = unmakeItem.FullMoveNumber;
+		for (size_t ply = 2; ply <= limit; ply += 2)
+		{
+			const UnmakeItem& previous = g_UnmakeList[g_UnmakeLength - ply];
+			if (previous.GetMoveMade().IsNull() || g_UnmakeList[g_UnmakeLength - ply + 1].GetMoveMade().IsNull()) return false;
+			if (previous.Key == g_key) return true;
+		}
+
+		return false;
 	}
 
-	bool Board::RecordStateToUnMake(
+	void Board::RecordStateToUnMake(
 		const Move& move)
 	{
-		if (g_UnmakeLength == g_UnmakeCapacity)
-		{
-			if (!IncreaseUnmakeListCapacity(g_UnmakeCapacity + UnmakeMoveListCapacityIncrement)) return false;
-		}
+		assert(g_UnmakeLength < FixedUnmakeMoveListCapacity);
 
 		// *** Move *** \\
 		
 		UnmakeItem& unmakeItem = g_UnmakeList[g_UnmakeLength];
 
-		unmakeItem.MovedFrom = move.MoveFrom;
-		unmakeItem.MovedTo = move.MoveTo;
-		unmakeItem.OriginalPiece.PieceColour = g_board[move.MoveFrom].PieceColour;
-		unmakeItem.OriginalPiece.PieceType = g_board[move.MoveFrom].PieceType;
-		unmakeItem.CapturedPiece.PieceColour = g_board[move.MoveTo].PieceColour;
-		unmakeItem.CapturedPiece.PieceType = g_board[move.MoveTo].PieceType;
-		unmakeItem.MovedFrom2 = move.SecondaryMoveFrom;
-		unmakeItem.MovedTo2 = move.SecondaryMoveTo;
-		unmakeItem.OtherReplaceSquare = move.OtherSquareToClear;
-		unmakeItem.OtherReplacePiece.PieceColour = g_board[move.OtherSquareToClear].PieceColour;
-		unmakeItem.OtherReplacePiece.PieceType = g_board[move.OtherSquareToClear].PieceType;
+		//For enpassant the captured pawn is not on the to square
+		BoardIndex0x88 capturedSquare = move.GetMoveTo();
+		if (move.IsEnpassant())
+		{
+			capturedSquare = move.GetOtherSquareToClear();
+		}
+
+		unmakeItem.MoveData = move.GetData();
+		unmakeItem.CapturedPiece = g_board[capturedSquare];
 
 		// *** State *** \\
 
-		unmakeItem.ColourToMove = g_colourToMove;
-		unmakeItem.CanWhiteCastleKingSide = g_canWhiteCastleKingSide;
-		unmakeItem.CanWhiteCastleQueenSide = g_canWhiteCastleQueenSide;
-		unmakeItem.CanBlackCastleKingSide = g_canBlackCastleKingSide;
-		unmakeItem.CanBlackCastleQueenSide = g_canBlackCastleQueenSide;
-		unmakeItem.WhiteKingLocation0x88 = g_WhiteKingLocation0x88;
-		unmakeItem.BlackKingLocation0x88 = g_BlackKingLocation0x88;
-		unmakeItem.EnpassantTargetSquare = g_EnpassantTargetSquare;
-		unmakeItem.HalfMoveClock = g_halfMoveClock;
-		unmakeItem.FullMoveNumber = g_fullMoveNumber;
+		unmakeItem.HalfMoveClock = g_state.HalfMoveClock;
+		unmakeItem.CastlingRights = g_state.CastlingRights;
+		unmakeItem.EnpassantTargetSquare = g_state.EnpassantTargetSquare;
+		unmakeItem.Key = g_key;
 
 		++g_UnmakeLength;
-		return true;
 	}
 
 	std::string Board::GetPositionAsFen()
 	{
-		std::stringstream result;
+		char buffer[FenBufferLength];
+		const size_t length = WritePositionAsFen(buffer);
+
+		return std::string(buffer, length);
+	}
+
+	size_t Board::WritePositionAsFen(char* buffer) const
+	{
+		//Indexed by Piece::PieceIndexXXX
+		static constexpr char whitePieces[Piece::PieceTypeCount] = { 'K', 'R', 'N', 'B', 'Q', 'P' };
+		static constexpr char blackPieces[Piece::PieceTypeCount] = { 'k', 'r', 'n', 'b', 'q', 'p' };
+
+		char* out = buffer;
 
 		for (int rank = 7; rank >= 0; --rank)
 		{
-			if (rank < 7) result << "/";
+			if (rank < 7) *out++ = '/';
 			int noPieceCount{ 0 };
 			for (int file = 0; file <= 7; ++file)
 			{
-				Piece& piece = g_board[FileRankTo0x88(file, rank)];
+				const PackedPiece piece = g_board[FileRankTo0x88(file, rank)];
 
-				if (piece.PieceType == Piece::PieceTypeNone)
+				if (piece == Piece::PackedPieceNone)
 				{
 					++noPieceCount;
 				}
 				else
 				{
-					if (noPieceCount > 0) result << noPieceCount;
+					if (noPieceCount > 0) *out++ = static_cast<char>('0' + noPieceCount);
 					noPieceCount = 0;
 
-					if (piece.PieceColour == Piece::PieceColourWhite)
-					{
-						//White
-						switch (piece.PieceType)
-						{
-						case Piece::PieceTypeRook:
-							result << "R";
-							break;
-						case Piece::PieceTypeKnight:
-							result << "N";
-							break;
-						case Piece::PieceTypeBishop:
-							result << "B";
-							break;
-						case Piece::PieceTypeQueen:
-							result << "Q";
-							break;
-						case Piece::PieceTypeKing:
-							result << "K";
-							break;
-						case Piece::PieceTypePawn:
-							result << "P";
-							break;
-						}
-					}
-					else
-					{
-						//Black
-						switch (piece.PieceType)
-						{
-						case Piece::PieceTypeRook:
-							result << "r";
-							break;
-						case Piece::PieceTypeKnight:
-							result << "n";
-							break;
-						case Piece::PieceTypeBishop:
-							result << "b";
-							break;
-						case Piece::PieceTypeQueen:
-							result << "q";
-							break;
-						case Piece::PieceTypeKing:
-							result << "k";
-							break;
-						case Piece::PieceTypePawn:
-							result << "p";
-							break;
-						}
-					}
+					const int pieceIndex = Piece::PieceTypeToIndex(Piece::GetPackedType(piece));
+					*out++ = Piece::GetPackedColour(piece) == Piece::PieceColourWhite ? whitePieces[pieceIndex] : blackPieces[pieceIndex];
 				}
 			}
-			if (noPieceCount > 0) result << noPieceCount;
+			if (noPieceCount > 0) *out++ = static_cast<char>('0' + noPieceCount);
 		}
 
-		if (g_colourToMove == Piece::PieceColourWhite)
+		*out++ = ' ';
+		*out++ = g_state.ColourToMove == Piece::PieceColourWhite ? 'w' : 'b';
+		*out++ = ' ';
+
+		if ((g_state.CastlingRights & BoardState::CastleAll) == 0)
 		{
-			result << " w ";
+			*out++ = '-';
 		}
 		else
 		{
-			result << " b ";
+			if ((g_state.CastlingRights & BoardState::CastleWhiteKingSide) != 0) *out++ = 'K';
+			if ((g_state.CastlingRights & BoardState::CastleWhiteQueenSide) != 0) *out++ = 'Q';
+			if ((g_state.CastlingRights & BoardState::CastleBlackKingSide) != 0) *out++ = 'k';
+			if ((g_state.CastlingRights & BoardState::CastleBlackQueenSide) != 0) *out++ = 'q';
 		}
+		*out++ = ' ';
 
-		if (!g_canWhiteCastleKingSide &&
-			!g_canWhiteCastleQueenSide &&
-			!g_canBlackCastleKingSide &&
-			!g_canBlackCastleQueenSide)
+		if (g_state.EnpassantTargetSquare == Null0x88Square)
 		{
-			result << "- ";
+			*out++ = '-';
 		}
 		else
 		{
-			if (g_canWhiteCastleKingSide) result << "K";
-			if (g_canWhiteCastleQueenSide) result << "Q";
-			if (g_canBlackCastleKingSide) result << "k";
-			if (g_canBlackCastleQueenSide) result << "q";
-			result << " ";
+			out += WriteTextSquare(g_state.EnpassantTargetSquare, out);
 		}
+		*out++ = ' ';
+
+		out += write_unsigned(g_state.HalfMoveClock, out);
+		*out++ = ' ';
+		out += write_unsigned(g_state.FullMoveNumber, out);
+
+		*out = '\0';
+
+		return static_cast<size_t>(out - buffer);
+	}
+
+	Move Board::ParseMove(const char* text, const size_t length)
+	{
+		if (length != 4 && length != 5) return Move();
+
+		const BoardIndex0x88 from = TextSquareTo0x88(text, 2);
+		const BoardIndex0x88 to = TextSquareTo0x88(text + 2, 2);
+		if (from == Null0x88Square || to == Null0x88Square) return Move();
 
-		if (g_EnpassantTargetSquare == Null0x88Square)
+		int promoteTo = Piece::PieceTypeNone;
+		if (length == 5)
 		{
-			result << "- ";
+			switch (text[4])
+			{
+			case 'q':
+			case 'Q':
+				promoteTo = Piece::PieceTypeQueen;
+				break;
+			case 'r':
+			case 'R':
+				promoteTo = Piece::PieceTypeRook;
+				break;
+			case 'b':
+			case 'B':
+				promoteTo = Piece::PieceTypeBishop;
+				break;
+			case 'n':
+			case 'N':
+				promoteTo = Piece::PieceTypeKnight;
+				break;
+			default:
+				return Move();
+			}
 		}
-		else
+
+		Move moves[MaxMovesInPosition];
+		int moveCount = 0;
+		GenerateLegalMoves(moves, moveCount);
+
+		for (int i = 0; i < moveCount; ++i)
 		{
-			char file = From0x88ToFileLetter(g_EnpassantTargetSquare);
-			int rank = From0x88ToRank(g_EnpassantTargetSquare) + 1;
-			result << file << rank << " ";
+			if (moves[i].GetMoveFrom() == from && moves[i].GetMoveTo() == to && moves[i].GetPromoteTo() == promoteTo)
+			{
+				return moves[i];
+			}
 		}
 
-		result << g_halfMoveClock << " ";
+		return Move();
+	}
+
+	bool Board::SetPositionFromFen(std::string fen)
+	{
+		return SetPositionFromFen(fen.data(), fen.size(), true);
+	}
 
-		result << g_fullMoveNumber;
+	bool Board::SetPositionFromFen(const char* fen, const size_t length, const bool validate)
+	{
+		return SetPositionFromText(fen, length, true, validate);
+	}
 
-		return result.str();
+	bool Board::SetPositionFromEpd(const char* epd, const size_t length, const bool validate)
+	{
+		return SetPositionFromText(epd, length, false, validate);
 	}
 
-	bool Board::SetPositionFromFen(std::string fen)
+	bool Board::SetPositionFromText(const char* text, const size_t length, const bool hasMoveCounters, const bool validate)
 	{
-		//TODO:
-		NewGame();
+		g_UnmakeLength = { 0 };
+
+		return CompleteSetPosition(ParsePosition(text, length, hasMoveCounters, validate));
+	}
 
-		std::stringstream input;
-		input << fen;
-		//TODO: Why is the following not needed
-		//input.seekg(0);		
-
-		std::string fields;
-		std::string activeColour;
-		std::string castling;
-		std::string enPassant;
-		std::string fifth;
-		std::string halfmove;
-		std::string fullmove;
-		input >> fields;
-		input >> activeColour;
-		input >> castling;
-		input >> enPassant;
-		input >> halfmove;
-		input >> fullmove;
-
-		if (fields == "") return false; //No need to call NewGame() here as so far no internal state is modified from standard
-		if (activeColour == "") return false; //No need to call NewGame() here as so far no internal state is modified from standard
-		if (castling == "") return false; //No need to call NewGame() here as so far no internal state is modified from standard
-		if (enPassant == "") return false; //No need to call NewGame() here as so far no internal state is modified from standard		
-
-		if (!ProcessFenFields(fields))
+	bool Board::CompleteSetPosition(const bool isValid)
+	{
+		if (!isValid)
 		{
 			NewGame();
 			return false;
 		}
 
-		if (activeColour == "w")
+		g_key = CalculateKey();
+		g_pawnKey = CalculatePawnKey();
+		g_materialSignature = CalculateMaterialSignature();
+
+		return true;
+	}
+
+	bool Board::GetPackedPosition(PackedPosition& packed) const
+	{
+		packed = PackedPosition();
+
+		int pieceCount = 0;
+		for (BoardIndex64 sq64 = 0; sq64 < 64; ++sq64)
+		{
+			const PackedPiece piece = g_board[Sq64To0x88(sq64)];
+			if (piece == Piece::PackedPieceNone) continue;
+			if (pieceCount == PackedPosition::MaxPieces) return false;
+
+			packed.Occupancy |= SquareBitboard(sq64);
+			packed.SetPieceNibble(
+				pieceCount,
+				Piece::PieceTypeToIndex(Piece::GetPackedType(piece)) |
+				(Piece::ColourToIndex(Piece::GetPackedColour(piece)) << PackedPosition::NibbleColourShift));
+			++pieceCount;
+		}
+
+		packed.HalfMoveClock = g_state.HalfMoveClock;
+		packed.FullMoveNumber = g_state.FullMoveNumber;
+		packed.ColourToMove = static_cast<unsigned char>(Piece::ColourToIndex(g_state.ColourToMove));
+		packed.CastlingRights = g_state.CastlingRights;
+		packed.EnpassantTargetSquare = static_cast<unsigned char>(g_state.EnpassantTargetSquare == Null0x88Square ?
+			NullSquare64 :
+			Sq0x88To64(g_state.EnpassantTargetSquare));
+
+		return true;
+	}
+
+	bool Board::SetPositionFromPacked(const PackedPosition& packed, const bool validate)
+	{
+		g_UnmakeLength = { 0 };
+
+		return CompleteSetPosition(UnpackPosition(packed, validate));
+	}
+
+	bool Board::UnpackPosition(const PackedPosition& packed, const bool validate)
+	{
+		ClearBoard();
+
+		Bitboard occupancy = packed.Occupancy;
+		if (PopCount(occupancy) > PackedPosition::MaxPieces) return false;
+
+		int pieceCount = 0;
+		while (occupancy != 0)
+		{
+			const BoardIndex0x88 sq = Sq64To0x88(PopLeastSignificantSquare(occupancy));
+			const int nibble = packed.GetPieceNibble(pieceCount);
+			++pieceCount;
+
+			const int pieceIndex = nibble & ((1 << PackedPosition::NibbleColourShift) - 1);
+			const int colour = Piece::IndexToColour(nibble >> PackedPosition::NibbleColourShift);
+			if (pieceIndex >= Piece::PieceTypeCount) return false;
+
+			g_board[sq] = Piece::Pack(Piece::IndexToPieceType(pieceIndex), colour);
+
+			if (pieceIndex == Piece::PieceIndexKing)
+			{
+				if (colour == Piece::PieceColourWhite)
+				{
+					g_state.WhiteKingLocation0x88 = sq;
+				}
+				else
+				{
+					g_state.BlackKingLocation0x88 = sq;
+				}
+			}
+		}
+
+		if (!RebuildPieceLists()) return false;
+
+		RebuildPieceBitboards();
+
+		if (packed.ColourToMove > Piece::ColourIndexBlack) return false;
+		if ((packed.CastlingRights & ~BoardState::CastleAll) != 0) return false;
+		if (packed.EnpassantTargetSquare > NullSquare64) return false;
+		if (packed.FullMoveNumber < 1 || packed.FullMoveNumber > MaxSetMoveCounter) return false;
+		if (packed.HalfMoveClock > MaxSetMoveCounter) return false;
+
+		g_state.ColourToMove = static_cast<unsigned char>(Piece::IndexToColour(packed.ColourToMove));
+		g_state.CastlingRights = packed.CastlingRights;
+		g_state.EnpassantTargetSquare = packed.EnpassantTargetSquare == NullSquare64 ?
+			Null0x88Square :
+			Sq64To0x88(packed.EnpassantTargetSquare);
+		g_state.HalfMoveClock = packed.HalfMoveClock;
+		g_state.FullMoveNumber = packed.FullMoveNumber;
+
+		return !validate || ValidatePosition();
+	}
+
+	bool Board::ParsePosition(const char* text, const size_t length, const bool hasMoveCounters, const bool validate)
+	{
+		const char* position = text;
+		const char* const end = text + length;
+		const char* field = nullptr;
+		size_t fieldLength = 0;
+
+		//Piece placement, active colour, castling and enpassant are required
+		if (!NextFenField(position, end, field, fieldLength)) return false;
+		if (!ProcessFenFields(field, fieldLength)) return false;
+		if (!RebuildPieceLists()) return false;
+
+		RebuildPieceBitboards();
+
+		if (!NextFenField(position, end, field, fieldLength) || fieldLength != 1) return false;
+		if (field[0] == 'w')
 		{
-			g_colourToMove = Piece::PieceColourWhite;
+			g_state.ColourToMove = Piece::PieceColourWhite;
 		}
-		else if (activeColour == "b")
+		else if (field[0] == 'b')
 		{
-			g_colourToMove = Piece::PieceColourBlack;
+			g_state.ColourToMove = Piece::PieceColourBlack;
 		}
 		else
 		{
-			NewGame();
 			return false;
 		}
 
-		g_canWhiteCastleKingSide = false;
-		g_canWhiteCastleQueenSide = false;
-		g_canBlackCastleKingSide = false;
-		g_canBlackCastleQueenSide = false;
-
-		if (castling != "-")
+		if (!NextFenField(position, end, field, fieldLength)) return false;
+		g_state.CastlingRights = 0;
+		if (fieldLength != 1 || field[0] != '-')
 		{
-			for (char c : castling)
+			for (size_t i = 0; i < fieldLength; ++i)
 			{
-				switch (c)
+				switch (field[i])
 				{
 				case 'K':
-					g_canWhiteCastleKingSide = true;
+					g_state.CastlingRights |= BoardState::CastleWhiteKingSide;
 					break;
 				case 'Q':
-					g_canWhiteCastleQueenSide = true;
+					g_state.CastlingRights |= BoardState::CastleWhiteQueenSide;
 					break;
 				case 'k':
-					g_canBlackCastleKingSide = true;
+					g_state.CastlingRights |= BoardState::CastleBlackKingSide;
 					break;
 				case 'q':
-					g_canBlackCastleQueenSide = true;
+					g_state.CastlingRights |= BoardState::CastleBlackQueenSide;
 					break;
 				default:
-					NewGame();
 					return false;
 				}
 			}
 		}
 
-		if (enPassant != "-")
+		if (!NextFenField(position, end, field, fieldLength)) return false;
+		g_state.EnpassantTargetSquare = { Null0x88Square };
+		if (fieldLength != 1 || field[0] != '-')
 		{
-			g_EnpassantTargetSquare = TextSquareTo0x88(enPassant);
-			if (g_EnpassantTargetSquare == Null0x88Square)
-			{
-				NewGame();
-				return false;
-			}
+			g_state.EnpassantTargetSquare = TextSquareTo0x88(field, fieldLength);
+			if (g_state.EnpassantTargetSquare == Null0x88Square) return false;
 		}
 
-		//TODO: Validate
-		if (halfmove != "")
+		//The move counters are optional, anything after them (or after the EPD fields) is ignored
+		g_state.HalfMoveClock = { 0 };
+		g_state.FullMoveNumber = { 1 };
+		if (hasMoveCounters && NextFenField(position, end, field, fieldLength))
 		{
-			if (!is_number(halfmove))
-			{
-				NewGame();
-				return false;
-			}
-			//TODO: Improve
-			if (halfmove.size() > 6)
-			{
-				NewGame();
-				return false;
-			}
-			g_halfMoveClock = std::stoi(halfmove);
-			if (g_halfMoveClock < 0)
-			{
-				NewGame();
-				return false;
-			}
-		}
+			int value = 0;
+			if (!ParseFenNumber(field, fieldLength, 0, value)) return false;
+			g_state.HalfMoveClock = static_cast<unsigned short>(value);
 
-		if (fullmove != "")
-		{
-			//TODO: Validate
-			if (!is_number(fullmove))
-			{
-				NewGame();
-				return false;
-			}
-			//TODO: Improve
-			if (fullmove.size() > 6)
-			{
-				NewGame();
-				return false;
-			}
-			g_fullMoveNumber = std::stoi(fullmove);
-			if (g_fullMoveNumber < 1)
+			if (NextFenField(position, end, field, fieldLength))
 			{
-				NewGame();
-				return false;
+				if (!ParseFenNumber(field, fieldLength, 1, value)) return false;
+				g_state.FullMoveNumber = static_cast<unsigned short>(value);
 			}
 		}
 
-		if (!ValidatePosition())
+		return !validate || ValidatePosition();
+	}
+
+	bool Board::NextFenField(const char*& position, const char* const end, const char*& field, size_t& fieldLength)
+	{
+		while (position != end && IsFenSpace(*position)) ++position;
+		if (position == end) return false;
+
+		field = position;
+		while (position != end && !IsFenSpace(*position)) ++position;
+		fieldLength = static_cast<size_t>(position - field);
+
+		return true;
+	}
+
+	bool Board::ParseFenNumber(const char* field, const size_t fieldLength, const int minimum, int& value)
+	{
+		//At most 6 digits so the value cannot overflow before the range test
+		if (fieldLength == 0 || fieldLength > 6) return false;
+
+		value = 0;
+		for (size_t i = 0; i < fieldLength; ++i)
 		{
-			NewGame();
-			return false;
+			if (field[i] < '0' || field[i] > '9') return false;
+			value = value * 10 + (field[i] - '0');
 		}
 
-		return true;
+		return value >= minimum && value <= MaxSetMoveCounter;
 	}
 
 
@@ -657,8 +1953,7 @@ namespace ATHENAZEROENG
 	{
 		for (int sq = 0; sq < BoardArrayLength; ++sq)
 		{
-			g_board[sq].PieceType = Piece::PieceTypeNone;
-			g_board[sq].PieceColour = Piece::PieceColourWhite;
+			g_board[sq] = Piece::PackedPieceNone;
 		}
 	}
 
@@ -700,40 +1995,91 @@ namespace ATHENAZEROENG
 			pieceColour = { Piece::PieceColourBlack };
 		}
 
-		SetPieceOnSquare(0, rank, Piece::PieceTypeRook, pieceColour);
-		SetPieceOnSquare(1, rank, Piece::PieceTypeKnight, pieceColour);
-		SetPieceOnSquare(2, rank, Piece::PieceTypeBishop, pieceColour);
-		SetPieceOnSquare(3, rank, Piece::PieceTypeQueen, pieceColour);
-		SetPieceOnSquare(4, rank, Piece::PieceTypeKing, pieceColour);
-		SetPieceOnSquare(5, rank, Piece::PieceTypeBishop, pieceColour);
-		SetPieceOnSquare(6, rank, Piece::PieceTypeKnight, pieceColour);
-		SetPieceOnSquare(7, rank, Piece::PieceTypeRook, pieceColour);
+		SetPieceOnSquare(0, rank, Piece::PieceTypeRook, pieceColour);
+		SetPieceOnSquare(1, rank, Piece::PieceTypeKnight, pieceColour);
+		SetPieceOnSquare(2, rank, Piece::PieceTypeBishop, pieceColour);
+		SetPieceOnSquare(3, rank, Piece::PieceTypeQueen, pieceColour);
+		SetPieceOnSquare(4, rank, Piece::PieceTypeKing, pieceColour);
+		SetPieceOnSquare(5, rank, Piece::PieceTypeBishop, pieceColour);
+		SetPieceOnSquare(6, rank, Piece::PieceTypeKnight, pieceColour);
+		SetPieceOnSquare(7, rank, Piece::PieceTypeRook, pieceColour);
+	}
+
+	void Board::SetPieceOnSquare(int file, int rank, int pieceType, int pieceColour)
+	{
+		BoardIndex0x88 sq = FileRankTo0x88(file, rank);
+		g_board[sq] = Piece::Pack(pieceType, pieceColour);
+	}
+
+	bool Board::RebuildPieceLists()
+	{
+		for (int colourIndex = 0; colourIndex < 2; ++colourIndex)
+		{
+			for (int pieceIndex = 0; pieceIndex < Piece::PieceTypeCount; ++pieceIndex)
+			{
+				g_pieceCount[colourIndex][pieceIndex] = 0;
+			}
+		}
+
+		for (BoardIndex0x88 sq = 0; sq < BoardArrayFirstNotPiecePos; ++sq)
+		{
+			if (Is0x88SquareValid(sq) && g_board[sq] != Piece::PackedPieceNone)
+			{
+				int colourIndex = Piece::ColourToIndex(Piece::GetPackedColour(g_board[sq]));
+				int pieceIndex = Piece::PieceTypeToIndex(Piece::GetPackedType(g_board[sq]));
+				if (g_pieceCount[colourIndex][pieceIndex] == MaxPiecesPerType) return false;
+
+				AddToPieceList(sq);
+			}
+		}
+
+		return true;
+	}
+
+	void Board::AddToPieceList(const BoardIndex0x88 square)
+	{
+		const PackedPiece piece = g_board[square];
+		const int colourIndex = Piece::ColourToIndex(Piece::GetPackedColour(piece));
+		const int pieceIndex = Piece::PieceTypeToIndex(Piece::GetPackedType(piece));
+
+		int& count = g_pieceCount[colourIndex][pieceIndex];
+		g_pieceList[colourIndex][pieceIndex][count] = square;
+		g_pieceListIndex[square] = count;
+		++count;
 	}
 
-	void Board::SetPieceOnSquare(int file, int rank, int pieceType, int pieceColour)
+	void Board::RemoveFromPieceList(const BoardIndex0x88 square)
 	{
-		BoardIndex0x88 sq = FileRankTo0x88(file, rank);
-		g_board[sq].PieceType = pieceType;
-		g_board[sq].PieceColour = pieceColour;
+		const PackedPiece piece = g_board[square];
+		const int colourIndex = Piece::ColourToIndex(Piece::GetPackedColour(piece));
+		const int pieceIndex = Piece::PieceTypeToIndex(Piece::GetPackedType(piece));
+
+		//Move the last piece of this type into the removed piece's slot
+		int& count = g_pieceCount[colourIndex][pieceIndex];
+		--count;
+		BoardIndex0x88 lastSquare = g_pieceList[colourIndex][pieceIndex][count];
+		int index = g_pieceListIndex[square];
+		g_pieceList[colourIndex][pieceIndex][index] = lastSquare;
+		g_pieceListIndex[lastSquare] = index;
+	}
+
+	void Board::MovePieceInList(const BoardIndex0x88 from, const BoardIndex0x88 to)
+	{
+		const PackedPiece piece = g_board[from];
+		const int index = g_pieceListIndex[from];
+
+		g_pieceList[Piece::ColourToIndex(Piece::GetPackedColour(piece))][Piece::PieceTypeToIndex(Piece::GetPackedType(piece))][index] = to;
+		g_pieceListIndex[to] = index;
 	}
 
 	void Board::AddMove(
 		const BoardIndex0x88 start,
 		const BoardIndex0x88 target,
-		const int promoteTo,
-		const BoardIndex0x88 otherSquareToClear,
-		const BoardIndex0x88 secondaryMoveFrom,
-		const BoardIndex0x88 secondaryMoveTo,
+		const unsigned int flags,
 		Move* moves,
 		int& moveCount)
 	{
-		Move& move = moves[moveCount];
-		move.MoveFrom = start;
-		move.MoveTo = target;
-		move.PromoteTo = promoteTo;
-		move.OtherSquareToClear = otherSquareToClear;
-		move.SecondaryMoveFrom = secondaryMoveFrom;
-		move.SecondaryMoveTo = secondaryMoveTo;
+		moves[moveCount] = Move(start, target, flags);
 
 		++moveCount;
 	}
@@ -742,6 +2088,7 @@ namespace ATHENAZEROENG
 		BoardIndex0x88 start,
 		int direction,
 		int maxCount,
+		int generationType,
 		Move* moves,
 		int& moveCount)
 	{
@@ -750,33 +2097,31 @@ namespace ATHENAZEROENG
 
 		while (Is0x88SquareValid(pos))
 		{
-			Piece& piece = g_board[pos];
-			if (piece.PieceType == Piece::PieceTypeNone)
+			const PackedPiece piece = g_board[pos];
+			if (piece == Piece::PackedPieceNone)
 			{
 				//Empty Square
-				AddMove(
-					start,
-					pos,
-					Piece::PieceTypeNone,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
-					moves,
-					moveCount);
+				if ((generationType & MoveGenerationQuiet) != 0)
+				{
+					AddMove(
+						start,
+						pos,
+						Move::MoveFlagQuiet,
+						moves,
+						moveCount);
+				}
 				++count;
 				if (count == maxCount) break; //Find no more
 				pos = pos + direction; //Next position
 			}
-			else if (piece.PieceColour != g_colourToMove)
+			else if ((piece & g_state.ColourToMove) == 0)
 			{
 				//Capture
+				if ((generationType & MoveGenerationNoisy) == 0) break;
 				AddMove(
 					start,
 					pos,
-					Piece::PieceTypeNone,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagCapture,
 					moves,
 					moveCount);
 				break; //Now stop - Do not pass through piece
@@ -789,223 +2134,169 @@ namespace ATHENAZEROENG
 		}
 	}
 
-	void Board::AddRookMoves(BoardIndex0x88 start, Move* moves, int& moveCount)
+	void Board::AddRookMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount)
 	{
-		AddBasicPieceMoves(start, BoardDirUp, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirDown, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirRight, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirLeft, 8, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirUp, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirDown, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirRight, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirLeft, 8, generationType, moves, moveCount);
 	}
 
-	void Board::AddKnightMoves(BoardIndex0x88 start, Move* moves, int& moveCount)
+	void Board::AddKnightMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount)
 	{
-		AddBasicPieceMoves(start, BoardDirKnight1, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirKnight2, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirKnight3, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirKnight4, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirKnight5, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirKnight6, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirKnight7, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirKnight8, 1, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirKnight1, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirKnight2, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirKnight3, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirKnight4, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirKnight5, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirKnight6, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirKnight7, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirKnight8, 1, generationType, moves, moveCount);
 	}
 
-	void Board::AddBishopMoves(BoardIndex0x88 start, Move* moves, int& moveCount)
+	void Board::AddBishopMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount)
 	{
-		AddBasicPieceMoves(start, BoardDirUpRight, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirDownLeft, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirUpLeft, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirDownRight, 8, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirUpRight, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirDownLeft, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirUpLeft, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirDownRight, 8, generationType, moves, moveCount);
 	}
 
-	void Board::AddQueenMoves(BoardIndex0x88 start, Move* moves, int& moveCount)
+	void Board::AddQueenMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount)
 	{
-		AddBasicPieceMoves(start, BoardDirUp, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirDown, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirRight, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirLeft, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirUpRight, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirDownLeft, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirUpLeft, 8, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirDownRight, 8, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirUp, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirDown, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirRight, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirLeft, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirUpRight, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirDownLeft, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirUpLeft, 8, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirDownRight, 8, generationType, moves, moveCount);
 	}
 
-	void Board::AddKingMoves(BoardIndex0x88 start, Move* moves, int& moveCount)
+	void Board::AddKingMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount)
 	{
-		AddBasicPieceMoves(start, BoardDirUp, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirDown, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirRight, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirLeft, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirUpRight, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirDownLeft, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirUpLeft, 1, moves, moveCount);
-		AddBasicPieceMoves(start, BoardDirDownRight, 1, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirUp, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirDown, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirRight, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirLeft, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirUpRight, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirDownLeft, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirUpLeft, 1, generationType, moves, moveCount);
+		AddBasicPieceMoves(start, BoardDirDownRight, 1, generationType, moves, moveCount);
+	}
 
-		//Castling
-		if (g_colourToMove == Piece::PieceColourWhite)
-		{
-			//White
-			if (g_canWhiteCastleKingSide)
-			{
-				if (g_board[0x05].PieceType == Piece::PieceTypeNone &&
-					g_board[0x06].PieceType == Piece::PieceTypeNone)
-				{
-					//King and Rook must be in position for castling kingside.
-					//Check tests are only tested on MakeMove()
-					AddMove(
-						0x04,
-						0x06,
-						Piece::PieceTypeNone,
-						Null0x88Square,
-						0x07,
-						0x05,
-						moves,
-						moveCount);
-				}
-			}
+	template <int Us>
+	void Board::AddCastlingMoves(Move* moves, int& moveCount)
+	{
+		constexpr bool isWhite = Us == Piece::PieceColourWhite;
+		constexpr unsigned int kingSide = isWhite ? BoardState::CastleWhiteKingSide : BoardState::CastleBlackKingSide;
+		constexpr unsigned int queenSide = isWhite ? BoardState::CastleWhiteQueenSide : BoardState::CastleBlackQueenSide;
+		constexpr BoardIndex0x88 kingSquare = isWhite ? 0x04 : 0x74;
 
-			if (g_canWhiteCastleQueenSide)
-			{
-				if (g_board[0x03].PieceType == Piece::PieceTypeNone &&
-					g_board[0x02].PieceType == Piece::PieceTypeNone &&
-					g_board[0x01].PieceType == Piece::PieceTypeNone)
-				{
-					//King and Rook must be in position for castling queenside.
-					//Check tests are only tested on MakeMove()
-					AddMove(
-						0x04,
-						0x02,
-						Piece::PieceTypeNone,
-						Null0x88Square,
-						0x00,
-						0x03,
-						moves,
-						moveCount);
-				}
-			}
-		}
-		else
+		if ((g_state.CastlingRights & kingSide) != 0)
 		{
-			//Black
-			if (g_canBlackCastleKingSide)
+			if (g_board[kingSquare + 1] == Piece::PackedPieceNone &&
+				g_board[kingSquare + 2] == Piece::PackedPieceNone)
 			{
-				if (g_board[0x75].PieceType == Piece::PieceTypeNone &&
-					g_board[0x76].PieceType == Piece::PieceTypeNone)
-				{
-					//King and Rook must be in position for castling kingside.
-					//Check tests are only tested on MakeMove()
-					AddMove(
-						0x74,
-						0x76,
-						Piece::PieceTypeNone,
-						Null0x88Square,
-						0x77,
-						0x75,
-						moves,
-						moveCount);
-				}
+				//King and Rook must be in position for castling kingside.
+				//Check tests are only tested on MakeMove()
+				AddMove(
+					kingSquare,
+					kingSquare + 2,
+					Move::MoveFlagKingSideCastle,
+					moves,
+					moveCount);
 			}
+		}
 
-			if (g_canBlackCastleQueenSide)
+		if ((g_state.CastlingRights & queenSide) != 0)
+		{
+			if (g_board[kingSquare - 1] == Piece::PackedPieceNone &&
+				g_board[kingSquare - 2] == Piece::PackedPieceNone &&
+				g_board[kingSquare - 3] == Piece::PackedPieceNone)
 			{
-				if (g_board[0x73].PieceType == Piece::PieceTypeNone &&
-					g_board[0x72].PieceType == Piece::PieceTypeNone &&
-					g_board[0x71].PieceType == Piece::PieceTypeNone)
-				{
-					//King and Rook must be in position for castling queenside.
-					//Check tests are only tested on MakeMove()
-					AddMove(
-						0x74,
-						0x72,
-						Piece::PieceTypeNone,
-						Null0x88Square,
-						0x70,
-						0x73,
-						moves,
-						moveCount);
-				}
+				//King and Rook must be in position for castling queenside.
+				//Check tests are only tested on MakeMove()
+				AddMove(
+					kingSquare,
+					kingSquare - 2,
+					Move::MoveFlagQueenSideCastle,
+					moves,
+					moveCount);
 			}
 		}
 	}
 
+	template <int Us>
 	void Board::AddPawnAdvance(
 		const BoardIndex0x88 initial,
 		const BoardIndex0x88 start,
-		const int direction,
-		const unsigned int promotionOperator,
-		const unsigned int promotionComparison,
 		bool isOnHomeSquare,
+		int generationType,
 		Move* moves,
 		int& moveCount)
 	{
+		constexpr int direction = Us == Piece::PieceColourWhite ? BoardDirPawnAdvanceSingleWhite : BoardDirPawnAdvanceSingleBlack;
+
 		BoardIndex0x88 target = start + direction;
 
 		if (!Is0x88SquareValid(target)) return;
 
-		if (g_board[target].PieceType == Piece::PieceTypeNone)
+		if (g_board[target] == Piece::PackedPieceNone)
 		{
-			if ((target & promotionOperator) == promotionComparison)
+			if ((target & 0x70) == GetPromotionRank<Us>())
 			{
 				//Promotion
+				if ((generationType & MoveGenerationNoisy) == 0) return;
 				AddMove(
 					initial,
 					target,
-					Piece::PieceTypeQueen,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagPromoteQueen,
 					moves,
 					moveCount);
 				AddMove(
 					initial,
 					target,
-					Piece::PieceTypeRook,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagPromoteRook,
 					moves,
 					moveCount);
 				AddMove(
 					initial,
 					target,
-					Piece::PieceTypeBishop,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagPromoteBishop,
 					moves,
 					moveCount);
 				AddMove(
 					initial,
 					target,
-					Piece::PieceTypeKnight,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagPromoteKnight,
 					moves,
 					moveCount);
 			}
-			else
+			else if ((generationType & MoveGenerationQuiet) != 0)
 			{
 				//No promotion
 				AddMove(
 					initial,
 					target,
-					Piece::PieceTypeNone,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					initial == start ? Move::MoveFlagQuiet : Move::MoveFlagDoublePawnPush,
 					moves,
 					moveCount);
 			}
+			else
+			{
+				//Only quiet moves follow, including the double move
+				return;
+			}
 
 			if (isOnHomeSquare)
 			{
-				AddPawnAdvance(
+				AddPawnAdvance<Us>(
 					initial,
 					target,
-					direction,
-					promotionOperator,
-					promotionComparison,
 					false,
+					generationType,
 					moves,
 					moveCount
 				);
@@ -1013,11 +2304,10 @@ namespace ATHENAZEROENG
 		}
 	}
 
+	template <int Us>
 	void Board::AddPawnCapture(
 		const BoardIndex0x88 start,
 		const int direction,
-		const unsigned int promotionOperator,
-		const unsigned int promotionComparison,
 		Move* moves,
 		int& moveCount)
 	{
@@ -1025,46 +2315,33 @@ namespace ATHENAZEROENG
 
 		if (!Is0x88SquareValid(target)) return;
 
-		if (g_board[target].PieceType != Piece::PieceTypeNone &&
-			g_board[target].PieceColour != g_colourToMove)
+		if (Piece::GetPackedColour(g_board[target]) == Piece::OtherColour(Us))
 		{
-			if ((target & promotionOperator) == promotionComparison)
+			if ((target & 0x70) == GetPromotionRank<Us>())
 			{
 				//Promotion
 				AddMove(
 					start,
 					target,
-					Piece::PieceTypeQueen,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagPromoteQueen | Move::MoveFlagCapture,
 					moves,
 					moveCount);
 				AddMove(
 					start,
 					target,
-					Piece::PieceTypeRook,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagPromoteRook | Move::MoveFlagCapture,
 					moves,
 					moveCount);
 				AddMove(
 					start,
 					target,
-					Piece::PieceTypeBishop,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagPromoteBishop | Move::MoveFlagCapture,
 					moves,
 					moveCount);
 				AddMove(
 					start,
 					target,
-					Piece::PieceTypeKnight,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagPromoteKnight | Move::MoveFlagCapture,
 					moves,
 					moveCount);
 			}
@@ -1074,474 +2351,330 @@ namespace ATHENAZEROENG
 				AddMove(
 					start,
 					target,
-					Piece::PieceTypeNone,
-					Null0x88Square,
-					Null0x88Square,
-					Null0x88Square,
+					Move::MoveFlagCapture,
 					moves,
 					moveCount);
 			}
 		}
 	}
 
-	void Board::AddPawnMoves(BoardIndex0x88 start, Move* moves, int& moveCount)
+	template <int Us>
+	void Board::AddPawnMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount)
 	{
-		if (g_colourToMove == Piece::PieceColourWhite)
-		{
-			//White
-
-			//Advance and promotion
-			AddPawnAdvance(start, start, BoardDirPawnAdvanceSingleWhite, 0x70, 0x70, (start & 0xE0) == 0, moves, moveCount);
-			//Capture
-			AddPawnCapture(start, BoardDirPawnCaptureLeftWhite, 0x70, 0x70, moves, moveCount);
-			AddPawnCapture(start, BoardDirPawnCaptureRightWhite, 0x70, 0x70, moves, moveCount);
-
-			if (g_EnpassantTargetSquare != Null0x88Square)
-			{
-				BoardIndex0x88 pos = start + BoardDirPawnCaptureLeftWhite;
-				if (pos == g_EnpassantTargetSquare)
-				{
-					AddMove(
-						start,
-						pos,
-						Piece::PieceTypeNone,
-						pos - 16,
-						Null0x88Square,
-						Null0x88Square,
-						moves,
-						moveCount);
-				}
+		constexpr bool isWhite = Us == Piece::PieceColourWhite;
+		constexpr int captureLeft = isWhite ? BoardDirPawnCaptureLeftWhite : BoardDirPawnCaptureLeftBlack;
+		constexpr int captureRight = isWhite ? BoardDirPawnCaptureRightWhite : BoardDirPawnCaptureRightBlack;
+		constexpr unsigned int homeRank = isWhite ? 0x10 : 0x60;
 
-				pos = start + BoardDirPawnCaptureRightWhite;
-				if (pos == g_EnpassantTargetSquare)
-				{
-					AddMove(
-						start,
-						pos,
-						Piece::PieceTypeNone,
-						pos - 16,
-						Null0x88Square,
-						Null0x88Square,
-						moves,
-						moveCount);
-				}
-			}
-		}
-		else
-		{
-			//Black
+		//Advance and promotion
+		AddPawnAdvance<Us>(start, start, (start & 0x70) == homeRank, generationType, moves, moveCount);
 
-			//Advance and promotion
-			AddPawnAdvance(start, start, BoardDirPawnAdvanceSingleBlack, 0xF0, 0x00, (start & 0x60) == 0x60, moves, moveCount);
+		if ((generationType & MoveGenerationNoisy) == 0) return;
 
-			//Capture
-			AddPawnCapture(start, BoardDirPawnCaptureRightBlack, 0xF0, 0x00, moves, moveCount);
-			AddPawnCapture(start, BoardDirPawnCaptureLeftBlack, 0xF0, 0x00, moves, moveCount);
+		//Capture
+		AddPawnCapture<Us>(start, captureLeft, moves, moveCount);
+		AddPawnCapture<Us>(start, captureRight, moves, moveCount);
 
-			if (g_EnpassantTargetSquare != Null0x88Square)
+		if (g_state.EnpassantTargetSquare != Null0x88Square)
+		{
+			BoardIndex0x88 pos = start + captureLeft;
+			if (pos == g_state.EnpassantTargetSquare)
 			{
-				BoardIndex0x88 pos = start + BoardDirPawnCaptureRightBlack;
-				if (pos == g_EnpassantTargetSquare)
-				{
-					AddMove(
-						start,
-						pos,
-						Piece::PieceTypeNone,
-						pos + 16,
-						Null0x88Square,
-						Null0x88Square,
-						moves,
-						moveCount);
-				}
+				AddMove(
+					start,
+					pos,
+					Move::MoveFlagEnpassant,
+					moves,
+					moveCount);
+			}
 
-				pos = start + BoardDirPawnCaptureLeftBlack;
-				if (pos == g_EnpassantTargetSquare)
-				{
-					AddMove(
-						start,
-						pos,
-						Piece::PieceTypeNone,
-						pos + 16,
-						Null0x88Square,
-						Null0x88Square,
-						moves, moveCount);
-				}
+			pos = start + captureRight;
+			if (pos == g_state.EnpassantTargetSquare)
+			{
+				AddMove(
+					start,
+					pos,
+					Move::MoveFlagEnpassant,
+					moves,
+					moveCount);
 			}
 		}
 	}
 
-	bool Board::IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-		const BoardIndex0x88 square,
-		const int attackingColour,
-		const int direction,
-		const int singleDirectionPieceType)
+	bool Board::IsSquareAttackedScan(const BoardIndex0x88 square, const int attackingColour)
 	{
-		BoardIndex0x88 target = square + direction;
+		const int colourIndex = Piece::ColourToIndex(attackingColour);
 
-		int count = 0;
-		while (Is0x88SquareValid(target))
+		for (int pieceIndex = 0; pieceIndex < Piece::PieceTypeCount; ++pieceIndex)
 		{
-			++count;
+			const int pieceType = Piece::IndexToPieceType(pieceIndex);
+			const CompactBoardIndex0x88* pieceList = g_pieceList[colourIndex][pieceIndex];
 
-			Piece& piece = g_board[target];
-
-			if (piece.PieceType != Piece::PieceTypeNone)
+			for (int i = 0; i < g_pieceCount[colourIndex][pieceIndex]; ++i)
 			{
-				//There is a piece
-				if (piece.PieceColour == attackingColour)
+				const BoardIndex0x88 source = pieceList[i];
+				const int delta = static_cast<int>(square) - static_cast<int>(source) + AttackDeltaOffset;
+				const int pieces = g_attackDeltaPieces[delta];
+
+				if ((pieces & pieceType) == 0) continue;
+
+				switch (pieceType)
+				{
+				case Piece::PieceTypePawn:
+					//Pawns only attack forwards
+					if ((pieces & attackingColour) != 0) return true;
+					break;
+				case Piece::PieceTypeKnight:
+				case Piece::PieceTypeKing:
+					return true;
+				default:
 				{
-					//A potentially attacking piece - check type
-					switch (piece.PieceType)
+					//Slider - Attacks if nothing is in the way
+					const int step = g_attackDeltaSteps[delta];
+					BoardIndex0x88 target = source + step;
+					while (target != square && g_board[target] == Piece::PackedPieceNone)
 					{
-					case Piece::PieceTypeQueen:
-						return true; //Attacked
-					case Piece::PieceTypeKing:
-						return count == 1; //In range so attacked
-					default:
-						return (piece.PieceType == singleDirectionPieceType);
+						target += step;
 					}
+					if (target == square) return true;
+					break;
 				}
-				else
-				{
-					//A friendly piece so not attacking but potentially blocking
-					return false;
 				}
-			} //Else, no piece so not attacking and can continue to the next square (if any)			
-
-			target += direction;
+			}
 		}
 
-		return false; //No attack
+		return false;
+	}
+
+	void Board::InitialiseAttackDeltas()
+	{
+		//Function level statics are only initialised once (and are thread safe)
+		static const bool initialised = BuildAttackDeltas();
+		(void)initialised;
 	}
 
-	bool Board::IsSquareAttackedByKnight(
-		const BoardIndex0x88 square,
-		const int attackingColour)
+	bool Board::BuildAttackDeltas()
 	{
-		BoardIndex0x88 target = square + BoardDirKnight1;
+		static constexpr int straightDirections[4] = { BoardDirUp, BoardDirDown, BoardDirRight, BoardDirLeft };
+		static constexpr int diagonalDirections[4] = { BoardDirUpRight, BoardDirDownLeft, BoardDirUpLeft, BoardDirDownRight };
+		static constexpr int knightDirections[8] = {
+			BoardDirKnight1, BoardDirKnight2, BoardDirKnight3, BoardDirKnight4,
+			BoardDirKnight5, BoardDirKnight6, BoardDirKnight7, BoardDirKnight8 };
 
-		if (Is0x88SquareValid(target))
+		for (int i = 0; i < AttackDeltaLength; ++i)
 		{
-			Piece& piece = g_board[target];
-			if (piece.PieceType == Piece::PieceTypeKnight &&
-				piece.PieceColour == attackingColour)
-			{
-				return true;
-			}
+			g_attackDeltaPieces[i] = 0;
+			g_attackDeltaSteps[i] = 0;
 		}
 
-		target = square + BoardDirKnight2;
-		if (Is0x88SquareValid(target))
+		for (int i = 0; i < 4; ++i)
 		{
-			Piece& piece = g_board[target];
-			if (piece.PieceType == Piece::PieceTypeKnight &&
-				piece.PieceColour == attackingColour)
+			for (int distance = 1; distance < 8; ++distance)
 			{
-				return true;
-			}
-		}
+				const int king = distance == 1 ? Piece::PieceTypeKing : Piece::PieceTypeNone;
 
+				int delta = straightDirections[i] * distance + AttackDeltaOffset;
+				g_attackDeltaPieces[delta] |= Piece::PieceTypeRook | Piece::PieceTypeQueen | king;
+				g_attackDeltaSteps[delta] = static_cast<signed char>(straightDirections[i]);
 
-		target = square + BoardDirKnight3;
-		if (Is0x88SquareValid(target))
-		{
-			Piece& piece = g_board[target];
-			if (piece.PieceType == Piece::PieceTypeKnight &&
-				piece.PieceColour == attackingColour)
-			{
-				return true;
+				delta = diagonalDirections[i] * distance + AttackDeltaOffset;
+				g_attackDeltaPieces[delta] |= Piece::PieceTypeBishop | Piece::PieceTypeQueen | king;
+				g_attackDeltaSteps[delta] = static_cast<signed char>(diagonalDirections[i]);
 			}
 		}
 
-		target = square + BoardDirKnight4;
-		if (Is0x88SquareValid(target))
+		for (int i = 0; i < 8; ++i)
 		{
-			Piece& piece = g_board[target];
-			if (piece.PieceType == Piece::PieceTypeKnight &&
-				piece.PieceColour == attackingColour)
-			{
-				return true;
-			}
+			g_attackDeltaPieces[knightDirections[i] + AttackDeltaOffset] |= Piece::PieceTypeKnight;
 		}
 
-		target = square + BoardDirKnight5;
-		if (Is0x88SquareValid(target))
-		{
-			Piece& piece = g_board[target];
-			if (piece.PieceType == Piece::PieceTypeKnight &&
-				piece.PieceColour == attackingColour)
-			{
-				return true;
-			}
-		}
+		g_attackDeltaPieces[BoardDirPawnCaptureLeftWhite + AttackDeltaOffset] |= Piece::PieceTypePawn | Piece::PieceColourWhite;
+		g_attackDeltaPieces[BoardDirPawnCaptureRightWhite + AttackDeltaOffset] |= Piece::PieceTypePawn | Piece::PieceColourWhite;
+		g_attackDeltaPieces[BoardDirPawnCaptureLeftBlack + AttackDeltaOffset] |= Piece::PieceTypePawn | Piece::PieceColourBlack;
+		g_attackDeltaPieces[BoardDirPawnCaptureRightBlack + AttackDeltaOffset] |= Piece::PieceTypePawn | Piece::PieceColourBlack;
+
+		return true;
+	}
 
-		target = square + BoardDirKnight6;
-		if (Is0x88SquareValid(target))
+	void Board::RebuildPieceBitboards()
+	{
+		for (int pieceIndex = 0; pieceIndex < Piece::PieceTypeCount; ++pieceIndex)
 		{
-			Piece& piece = g_board[target];
-			if (piece.PieceType == Piece::PieceTypeKnight &&
-				piece.PieceColour == attackingColour)
-			{
-				return true;
-			}
+			g_pieceBitboards[pieceIndex] = 0;
 		}
+		g_colourBitboards[Piece::ColourIndexWhite] = 0;
+		g_colourBitboards[Piece::ColourIndexBlack] = 0;
 
-		target = square + BoardDirKnight7;
-		if (Is0x88SquareValid(target))
+		for (BoardIndex0x88 sq = 0; sq < BoardArrayFirstNotPiecePos; ++sq)
 		{
-			Piece& piece = g_board[target];
-			if (piece.PieceType == Piece::PieceTypeKnight &&
-				piece.PieceColour == attackingColour)
+			if (Is0x88SquareValid(sq) && g_board[sq] != Piece::PackedPieceNone)
 			{
-				return true;
+				TogglePieceBitboards(sq, g_board[sq]);
 			}
 		}
+	}
+
+	ZobristKey Board::CalculateKey() const
+	{
+		ZobristKey key = GetStateKey();
+		if (g_state.ColourToMove == Piece::PieceColourBlack) key ^= Zobrist::GetBlackToMoveKey();
 
-		target = square + BoardDirKnight8;
-		if (Is0x88SquareValid(target))
+		for (BoardIndex0x88 sq = 0; sq < BoardArrayFirstNotPiecePos; ++sq)
 		{
-			Piece& piece = g_board[target];
-			if (piece.PieceType == Piece::PieceTypeKnight &&
-				piece.PieceColour == attackingColour)
+			if (Is0x88SquareValid(sq) && g_board[sq] != Piece::PackedPieceNone)
 			{
-				return true;
+				key ^= GetPieceKey(g_board[sq], sq);
 			}
 		}
 
-		return false;
+		return key;
 	}
 
-	bool Board::IsAttackedByPawn(
-		const BoardIndex0x88 square,
-		const int attackingColour,
-		const int direction1,
-		const int direction2)
+	ZobristKey Board::CalculatePawnKey() const
 	{
-		BoardIndex0x88 target = square + direction1;
+		ZobristKey key = 0;
 
-		if (Is0x88SquareValid(target))
+		for (BoardIndex0x88 sq = 0; sq < BoardArrayFirstNotPiecePos; ++sq)
 		{
-			Piece& piece = g_board[target];
-
-			if (piece.PieceType == Piece::PieceTypePawn &&
-				piece.PieceColour == attackingColour)
+			if (Is0x88SquareValid(sq) && Piece::GetPackedType(g_board[sq]) == Piece::PieceTypePawn)
 			{
-				return true;
+				key ^= GetPieceKey(g_board[sq], sq);
 			}
 		}
 
-		target = square + direction2;
+		return key;
+	}
 
-		if (Is0x88SquareValid(target))
-		{
-			Piece& piece = g_board[target];
+	MaterialSignature Board::CalculateMaterialSignature() const
+	{
+		MaterialSignature signature = 0;
 
-			if (piece.PieceType == Piece::PieceTypePawn &&
-				piece.PieceColour == attackingColour)
+		for (BoardIndex0x88 sq = 0; sq < BoardArrayFirstNotPiecePos; ++sq)
+		{
+			if (Is0x88SquareValid(sq) && g_board[sq] != Piece::PackedPieceNone)
 			{
-				return true;
+				signature += GetMaterialUnit(g_board[sq]);
 			}
 		}
 
-		return false;
+		return signature;
 	}
 
-	bool Board::IsSquareAttacked(const BoardIndex0x88 square, const int attackingColour)
-	{
-		if (IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-			square,
-			attackingColour,
-			BoardDirUp,
-			Piece::PieceTypeRook)) return true;
-		if (IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-			square,
-			attackingColour,
-			BoardDirDown,
-			Piece::PieceTypeRook)) return true;
-		if (IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-			square,
-			attackingColour,
-			BoardDirRight,
-			Piece::PieceTypeRook)) return true;
-		if (IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-			square,
-			attackingColour,
-			BoardDirLeft,
-			Piece::PieceTypeRook)) return true;
-
-		if (IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-			square,
-			attackingColour,
-			BoardDirUpRight,
-			Piece::PieceTypeBishop)) return true;
-		if (IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-			square,
-			attackingColour,
-			BoardDirDownLeft,
-			Piece::PieceTypeBishop)) return true;
-		if (IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-			square,
-			attackingColour,
-			BoardDirUpLeft,
-			Piece::PieceTypeBishop)) return true;
-		if (IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-			square,
-			attackingColour,
-			BoardDirDownRight,
-			Piece::PieceTypeBishop)) return true;
-
-		if (IsSquareAttackedByKnight(square, attackingColour)) return true;
-
-		if (attackingColour == Piece::PieceColourWhite)
-		{
-			//White attacking black
-			if (IsAttackedByPawn(
-				square,
-				attackingColour,
-				BoardDirTowardsAttackingWhitePawn1,
-				BoardDirTowardsAttackingWhitePawn2)) return true;
-		}
-		else
-		{
-			//Black attacking white
-			if (IsAttackedByPawn(
-				square,
-				attackingColour,
-				BoardDirTowardsAttackingBlackPawn1,
-				BoardDirTowardsAttackingBlackPawn2)) return true;
-		}
+	void Board::PlacePiece(const BoardIndex0x88 square, const PackedPiece piece)
+	{
+		g_board[square] = piece;
+		TogglePieceBitboards(square, piece);
+		AddToPawnAndMaterialKeys(square, piece);
+	}
 
-		return false;
+	void Board::ClearPiece(const BoardIndex0x88 square)
+	{
+		RemoveFromPawnAndMaterialKeys(square, g_board[square]);
+		TogglePieceBitboards(square, g_board[square]);
+		g_board[square] = Piece::PackedPieceNone;
 	}
 
-	bool Board::ProcessFenFields(const std::string& fields)
+	void Board::ReplacePiece(const BoardIndex0x88 square, const PackedPiece piece)
 	{
-		ClearBoard();
+		RemoveFromPawnAndMaterialKeys(square, g_board[square]);
+		TogglePieceBitboards(square, g_board[square]);
+		g_board[square] = piece;
+		TogglePieceBitboards(square, piece);
+		AddToPawnAndMaterialKeys(square, piece);
+	}
 
-		std::string s = fields;
+	bool Board::ProcessFenFields(const char* fields, const size_t length)
+	{
+		ClearBoard();
 
 		int rank = 7;
+		int file = { 0 };
 
-		size_t pos = s.find('/');
-
-		std::string row;
-
-		if (pos == std::string::npos)
-		{
-			row = s;
-			s = "";
-		}
-		else
-		{
-			row = s.substr(0, pos);
-			s.erase(0, pos + 1);
-		}
-
-		while (row.size() > 0)
+		for (size_t i = 0; i < length; ++i)
 		{
-			if (rank < 0)
-			{
-				return false;
-			}
-
-			int file = { 0 };
+			const char c = fields[i];
 
-			for (char c : row)
+			if (c == '/')
 			{
-				if (file > 7)
-				{
-					return false;
-				}
-				switch (c)
+				if (file != 8 || rank == 0)
 				{
-				case 'K':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeKing, Piece::PieceColourWhite);
-					g_WhiteKingLocation0x88 = FileRankTo0x88(file, rank);
-					++file;
-					break;
-				case 'Q':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeQueen, Piece::PieceColourWhite);
-					++file;
-					break;
-				case 'R':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeRook, Piece::PieceColourWhite);
-					++file;
-					break;
-				case 'N':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeKnight, Piece::PieceColourWhite);
-					++file;
-					break;
-				case 'B':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeBishop, Piece::PieceColourWhite);
-					++file;
-					break;
-				case 'P':
-					SetPieceOnSquare(file, rank, Piece::PieceTypePawn, Piece::PieceColourWhite);
-					++file;
-					break;
-				case 'k':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeKing, Piece::PieceColourBlack);
-					g_BlackKingLocation0x88 = FileRankTo0x88(file, rank);
-					++file;
-					break;
-				case 'q':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeQueen, Piece::PieceColourBlack);
-					++file;
-					break;
-				case 'r':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeRook, Piece::PieceColourBlack);
-					++file;
-					break;
-				case 'n':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeKnight, Piece::PieceColourBlack);
-					++file;
-					break;
-				case 'b':
-					SetPieceOnSquare(file, rank, Piece::PieceTypeBishop, Piece::PieceColourBlack);
-					++file;
-					break;
-				case 'p':
-					SetPieceOnSquare(file, rank, Piece::PieceTypePawn, Piece::PieceColourBlack);
-					++file;
-					break;
-				default:
-					//TODO: OK - Make a library function
-					if (c < '0' || c > '8')
-					{
-						return false;
-					}
-					std::stringstream ss;
-					ss << c;
-					int fileCount = std::stoi(ss.str());
-					file += fileCount;
-					break;
+					return false; //Not enough/too many files or ranks
 				}
+				--rank;
+				file = 0;
+				continue;
 			}
 
-			if (file != 8)
+			if (file > 7)
 			{
-				return false; //Not enough/too many ranks
+				return false;
 			}
 
-			--rank;
-
-			pos = s.find('/');
-
-			if (pos == std::string::npos)
-			{
-				row = s;
-				s = "";
-			}
-			else
+			switch (c)
 			{
-				row = s.substr(0, pos);
-				s.erase(0, pos + 1);
+			case 'K':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeKing, Piece::PieceColourWhite);
+				g_state.WhiteKingLocation0x88 = FileRankTo0x88(file, rank);
+				++file;
+				break;
+			case 'Q':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeQueen, Piece::PieceColourWhite);
+				++file;
+				break;
+			case 'R':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeRook, Piece::PieceColourWhite);
+				++file;
+				break;
+			case 'N':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeKnight, Piece::PieceColourWhite);
+				++file;
+				break;
+			case 'B':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeBishop, Piece::PieceColourWhite);
+				++file;
+				break;
+			case 'P':
+				SetPieceOnSquare(file, rank, Piece::PieceTypePawn, Piece::PieceColourWhite);
+				++file;
+				break;
+			case 'k':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeKing, Piece::PieceColourBlack);
+				g_state.BlackKingLocation0x88 = FileRankTo0x88(file, rank);
+				++file;
+				break;
+			case 'q':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeQueen, Piece::PieceColourBlack);
+				++file;
+				break;
+			case 'r':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeRook, Piece::PieceColourBlack);
+				++file;
+				break;
+			case 'n':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeKnight, Piece::PieceColourBlack);
+				++file;
+				break;
+			case 'b':
+				SetPieceOnSquare(file, rank, Piece::PieceTypeBishop, Piece::PieceColourBlack);
+				++file;
+				break;
+			case 'p':
+				SetPieceOnSquare(file, rank, Piece::PieceTypePawn, Piece::PieceColourBlack);
+				++file;
+				break;
+			default:
+				if (c < '1' || c > '8')
+				{
+					return false;
+				}
+				file += c - '0';
+				break;
 			}
 		}
 
-		if (rank != -1)
+		if (file != 8 || rank != 0)
 		{
-			return false; //Not enough/too many files
+			return false; //Not enough/too many files or ranks
 		}
 
 		return true;
@@ -1563,8 +2696,8 @@ namespace ATHENAZEROENG
 			for (int rank = 0; rank < 8; ++rank)
 			{
 				BoardIndex0x88 sq = FileRankTo0x88(file, rank);
-				int piece = g_board[sq].PieceType;
-				int colour = g_board[sq].PieceColour;
+				int piece = Piece::GetPackedType(g_board[sq]);
+				int colour = Piece::GetPackedColour(g_board[sq]);
 
 				if (piece == Piece::PieceTypeKing)
 				{
@@ -1604,10 +2737,10 @@ namespace ATHENAZEROENG
 			return false;
 		}
 
-		if (g_colourToMove == Piece::PieceColourWhite)
+		if (g_state.ColourToMove == Piece::PieceColourWhite)
 		{
 			//Black must not be in check
-			if (IsSquareAttacked(g_BlackKingLocation0x88, Piece::PieceColourWhite))
+			if (IsSquareAttacked(g_state.BlackKingLocation0x88, Piece::PieceColourWhite))
 			{
 				return false;
 			}
@@ -1615,137 +2748,133 @@ namespace ATHENAZEROENG
 		else
 		{
 			//White must not be in check
-			if (IsSquareAttacked(g_WhiteKingLocation0x88, Piece::PieceColourBlack))
+			if (IsSquareAttacked(g_state.WhiteKingLocation0x88, Piece::PieceColourBlack))
 			{
 				return false;
 			}
 		}
 
-		if (g_EnpassantTargetSquare != Null0x88Square)
+		if (g_state.EnpassantTargetSquare != Null0x88Square)
 		{
-			int rank = From0x88ToRank(g_EnpassantTargetSquare);
-			int file = From0x88ToFile(g_EnpassantTargetSquare);
+			int rank = From0x88ToRank(g_state.EnpassantTargetSquare);
+			int file = From0x88ToFile(g_state.EnpassantTargetSquare);
 			if (rank == 2)
 			{
-				if (g_colourToMove == Piece::PieceColourWhite)
+				if (g_state.ColourToMove == Piece::PieceColourWhite)
 				{
-					g_EnpassantTargetSquare = Null0x88Square;
+					g_state.EnpassantTargetSquare = Null0x88Square;
 				}
 				++rank;
 				BoardIndex0x88 sq = FileRankTo0x88(file, rank);
-				if (g_board[sq].PieceColour != Piece::PieceColourWhite ||
-					g_board[sq].PieceType != Piece::PieceTypePawn)
+				if (Piece::GetPackedColour(g_board[sq]) != Piece::PieceColourWhite ||
+					Piece::GetPackedType(g_board[sq]) != Piece::PieceTypePawn)
 				{
-					g_EnpassantTargetSquare = Null0x88Square;
+					g_state.EnpassantTargetSquare = Null0x88Square;
 				}
 			}
 			else if (rank == 5)
 			{
-				if (g_colourToMove == Piece::PieceColourBlack)
+				if (g_state.ColourToMove == Piece::PieceColourBlack)
 				{
-					g_EnpassantTargetSquare = Null0x88Square;
+					g_state.EnpassantTargetSquare = Null0x88Square;
 				}
 				--rank;
 				BoardIndex0x88 sq = FileRankTo0x88(file, rank);
-				if (g_board[sq].PieceColour != Piece::PieceColourBlack ||
-					g_board[sq].PieceType != Piece::PieceTypePawn)
+				if (Piece::GetPackedColour(g_board[sq]) != Piece::PieceColourBlack ||
+					Piece::GetPackedType(g_board[sq]) != Piece::PieceTypePawn)
 				{
-					g_EnpassantTargetSquare = Null0x88Square;
+					g_state.EnpassantTargetSquare = Null0x88Square;
 				}
 			}
 			else
 			{
-				g_EnpassantTargetSquare = Null0x88Square;
+				g_state.EnpassantTargetSquare = Null0x88Square;
 			}
 		}
 
-		if (g_canWhiteCastleKingSide)
+		if ((g_state.CastlingRights & BoardState::CastleWhiteKingSide) != 0)
 		{
 			//Must be a white king on 0x04 and white Rook on 0x07
-			if (g_board[0x04].PieceColour != Piece::PieceColourWhite ||
-				g_board[0x04].PieceType != Piece::PieceTypeKing)
+			if (Piece::GetPackedColour(g_board[0x04]) != Piece::PieceColourWhite ||
+				Piece::GetPackedType(g_board[0x04]) != Piece::PieceTypeKing)
 			{
-				g_canWhiteCastleKingSide = false;
+				g_state.CastlingRights &= ~BoardState::CastleWhiteKingSide;
 			}
 
-			if (g_board[0x07].PieceColour != Piece::PieceColourWhite ||
-				g_board[0x07].PieceType != Piece::PieceTypeRook)
+			if (Piece::GetPackedColour(g_board[0x07]) != Piece::PieceColourWhite ||
+				Piece::GetPackedType(g_board[0x07]) != Piece::PieceTypeRook)
 			{
-				g_canWhiteCastleKingSide = false;
+				g_state.CastlingRights &= ~BoardState::CastleWhiteKingSide;
 			}
 		}
 
-		if (g_canWhiteCastleQueenSide)
+		if ((g_state.CastlingRights & BoardState::CastleWhiteQueenSide) != 0)
 		{
 			//Must be a white king on 0x04 and white Rook on 0x00
-			if (g_board[0x04].PieceColour != Piece::PieceColourWhite ||
-				g_board[0x04].PieceType != Piece::PieceTypeKing)
+			if (Piece::GetPackedColour(g_board[0x04]) != Piece::PieceColourWhite ||
+				Piece::GetPackedType(g_board[0x04]) != Piece::PieceTypeKing)
 			{
-				g_canWhiteCastleQueenSide = false;
+				g_state.CastlingRights &= ~BoardState::CastleWhiteQueenSide;
 			}
 
-			if (g_board[0x00].PieceColour != Piece::PieceColourWhite ||
-				g_board[0x00].PieceType != Piece::PieceTypeRook)
+			if (Piece::GetPackedColour(g_board[0x00]) != Piece::PieceColourWhite ||
+				Piece::GetPackedType(g_board[0x00]) != Piece::PieceTypeRook)
 			{
-				g_canWhiteCastleQueenSide = false;
+				g_state.CastlingRights &= ~BoardState::CastleWhiteQueenSide;
 			}
 		}
 
-		if (g_canBlackCastleKingSide)
+		if ((g_state.CastlingRights & BoardState::CastleBlackKingSide) != 0)
 		{
 			//Must be a black king on 0x74 and black Rook on 0x77
-			if (g_board[0x74].PieceColour != Piece::PieceColourBlack ||
-				g_board[0x74].PieceType != Piece::PieceTypeKing)
+			if (Piece::GetPackedColour(g_board[0x74]) != Piece::PieceColourBlack ||
+				Piece::GetPackedType(g_board[0x74]) != Piece::PieceTypeKing)
 			{
-				g_canBlackCastleKingSide = false;
+				g_state.CastlingRights &= ~BoardState::CastleBlackKingSide;
 			}
 
-			if (g_board[0x77].PieceColour != Piece::PieceColourBlack ||
-				g_board[0x77].PieceType != Piece::PieceTypeRook)
+			if (Piece::GetPackedColour(g_board[0x77]) != Piece::PieceColourBlack ||
+				Piece::GetPackedType(g_board[0x77]) != Piece::PieceTypeRook)
 			{
-				g_canBlackCastleKingSide = false;
+				g_state.CastlingRights &= ~BoardState::CastleBlackKingSide;
 			}
 		}
 
-		if (g_canBlackCastleQueenSide)
+		if ((g_state.CastlingRights & BoardState::CastleBlackQueenSide) != 0)
 		{
 			//Must be a black king on 0x74 and black Rook on 0x70
 			//Must be a black king on 0x74 and black Rook on 0x77
-			if (g_board[0x74].PieceColour != Piece::PieceColourBlack ||
-				g_board[0x74].PieceType != Piece::PieceTypeKing)
+			if (Piece::GetPackedColour(g_board[0x74]) != Piece::PieceColourBlack ||
+				Piece::GetPackedType(g_board[0x74]) != Piece::PieceTypeKing)
 			{
-				g_canBlackCastleQueenSide = false;
+				g_state.CastlingRights &= ~BoardState::CastleBlackQueenSide;
 			}
 
-			if (g_board[0x70].PieceColour != Piece::PieceColourBlack ||
-				g_board[0x70].PieceType != Piece::PieceTypeRook)
+			if (Piece::GetPackedColour(g_board[0x70]) != Piece::PieceColourBlack ||
+				Piece::GetPackedType(g_board[0x70]) != Piece::PieceTypeRook)
 			{
-				g_canBlackCastleQueenSide = false;
+				g_state.CastlingRights &= ~BoardState::CastleBlackQueenSide;
 			}
 		}
 
 		return true;
 	}
 
-	bool Board::IsInCheck(int colour)
-	{
-		if (colour == 1) return false;
-		return false;
-	}
-
-	bool Board::IncreaseUnmakeListCapacity(size_t newCapacity)
-	{
-		UnmakeItem* newUnmakeList = new UnmakeItem[newCapacity];
-		if (newUnmakeList == nullptr) return false;
-
-		for (size_t i = 0; i < g_UnmakeLength; ++i)
-		{
-			newUnmakeList[i] = g_UnmakeList[i];
-		}
-
-		delete[] g_UnmakeList;
-		g_UnmakeList = newUnmakeList;
-		g_UnmakeCapacity = { newCapacity };
-		return true;
-	}
+	//The colour templated methods used outside this file
+	template void Board::GeneratePseudoLegalMoves<Piece::PieceColourWhite>(Move* moves, int& moveCount);
+	template void Board::GenerateMoves<Piece::PieceColourWhite>(int generationType, Move* moves, int& moveCount);
+	template void Board::GenerateCaptures<Piece::PieceColourWhite>(Move* moves, int& moveCount);
+	template void Board::GenerateEvasions<Piece::PieceColourWhite>(Move* moves, int& moveCount);
+	template void Board::GenerateLegalMoves<Piece::PieceColourWhite>(Move* moves, int& moveCount);
+	template int Board::CountLegalMoves<Piece::PieceColourWhite>();
+	template bool Board::MakeMove<Piece::PieceColourWhite>(const Move& move);
+	template bool Board::MakeLegalMove<Piece::PieceColourWhite>(const Move& move);
+	template void Board::GeneratePseudoLegalMoves<Piece::PieceColourBlack>(Move* moves, int& moveCount);
+	template void Board::GenerateMoves<Piece::PieceColourBlack>(int generationType, Move* moves, int& moveCount);
+	template void Board::GenerateCaptures<Piece::PieceColourBlack>(Move* moves, int& moveCount);
+	template void Board::GenerateEvasions<Piece::PieceColourBlack>(Move* moves, int& moveCount);
+	template void Board::GenerateLegalMoves<Piece::PieceColourBlack>(Move* moves, int& moveCount);
+	template int Board::CountLegalMoves<Piece::PieceColourBlack>();
+	template bool Board::MakeMove<Piece::PieceColourBlack>(const Move& move);
+	template bool Board::MakeLegalMove<Piece::PieceColourBlack>(const Move& move);
 }
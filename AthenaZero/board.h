@@ -26,12 +26,25 @@
 #include "typedefs.h"
 #include "board0x88lib.h"
 #include "unmake.h"
+#include "boardstate.h"
+#include "bitboardlib.h"
+#include "bitboardattacks.h"
+#include "zobrist.h"
+#include "constants.h"
+#include "packedposition.h"
 
 namespace ATHENAZEROENG
 {
 	class Board
 	{
 	public:
+		/*
+			The kinds of move to generate, see GenerateMoves(). Bit flags.
+		*/
+		static constexpr int MoveGenerationQuiet = 1;
+		static constexpr int MoveGenerationNoisy = 2;
+		static constexpr int MoveGenerationAll = MoveGenerationQuiet | MoveGenerationNoisy;
+
 		/*
 			Creates a new instance of the class and initialises a new game starting at the standard chess
 			starting position.
@@ -39,9 +52,18 @@ namespace ATHENAZEROENG
 		Board();
 
 		/*
-			Releases resources.
+			Copies a board, e.g. to hand a position to another thread. Only the live part of the
+			unmake stack (the moves made so far) is copied, so the copy can unmake them and detect
+			repetitions, but a board with no moves made copies only the position itself.
+		*/
+		Board(const Board& other);
+		Board& operator=(const Board& other);
+
+		/*
+			The board owns no heap memory, so moving is the same as copying.
 		*/
-		~Board();
+		Board(Board&& other) noexcept;
+		Board& operator=(Board&& other) noexcept;
 
 		/*
 			Resets to the start of a new game starting at the standard chess
@@ -53,6 +75,7 @@ namespace ATHENAZEROENG
 			Generates pseudo legal moves. These are moves that are valid, but may leave the player
 			in check or castling may not be possible due to check
 			or obstruction. Calling MakeMove() with one of these moves will do these tests.
+			When the side to move is in check only the evasions are generated (see GenerateEvasions()).
 
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
@@ -62,17 +85,171 @@ namespace ATHENAZEROENG
 		*/
 		void GeneratePseudoLegalMoves(Move* moves, int& moveCount);
 
+		/*
+			Generates some of the pseudo legal moves. Used to generate moves in stages
+			(see MovePicker) so moves that are never tried are never generated.
+
+			generationType: The moves to generate. One of:
+				* MoveGenerationNoisy - Captures, enpassant and promotions.
+				* MoveGenerationQuiet - All other moves, including castling.
+				* MoveGenerationAll - Both. Unlike GeneratePseudoLegalMoves() this does not
+				  switch to the evasions when in check, so every pseudo legal move is generated.
+			moves: An array. Should be at least 238 in length to avoid
+				   potential overflows.
+			moveCount: Initially set to 0 by this method. When the method returns
+					   this will contain the count of moves added to the moves
+					   array.
+		*/
+		void GenerateMoves(int generationType, Move* moves, int& moveCount);
+
+		/*
+			Generates pseudo legal captures, enpassant and promotions only, e.g. for quiescence
+			search. Gives the same moves as GenerateMoves(MoveGenerationNoisy, ...) but finds the
+			captures from the attackers of each enemy piece so quiet squares are never walked.
+			Moves are added most valuable victim first: captures, then enpassant with the pawn
+			victims, then promotions that do not capture.
+
+			moves: An array. Should be at least 238 in length to avoid
+				   potential overflows.
+			moveCount: Initially set to 0 by this method. When the method returns
+					   this will contain the count of moves added to the moves
+					   array.
+		*/
+		void GenerateCaptures(Move* moves, int& moveCount);
+
+		/*
+			Generates the pseudo legal moves that may get the side to move out of check: legal
+			king moves, captures of the checking piece and moves onto the squares between a
+			checking slider and the king. In double check only the king moves are generated.
+			Only call when the side to move is in check (see IsInCheck()).
+
+			moves: An array. Should be at least 238 in length to avoid
+				   potential overflows.
+			moveCount: Initially set to 0 by this method. When the method returns
+					   this will contain the count of moves added to the moves
+					   array.
+		*/
+		void GenerateEvasions(Move* moves, int& moveCount);
+
+		/*
+			Generates legal moves only. Checking pieces and pinned pieces are found once for
+			the position so moves that would leave the king in check are never generated. Use
+			MakeLegalMove() to make the moves, which skips the check tests done by MakeMove().
+
+			moves: An array. Should be at least 238 in length to avoid
+				   potential overflows.
+			moveCount: Initially set to 0 by this method. When the method returns
+					   this will contain the count of moves added to the moves
+					   array.
+		*/
+		void GenerateLegalMoves(Move* moves, int& moveCount);
+
+		/*
+			Counts the legal moves without generating them (e.g. for perft at depth 1, or
+			testing for checkmate and stalemate). The moves of unpinned knights, bishops,
+			rooks and queens are counted from their attack bitboards, pawn moves are counted
+			square by square. Only the king moves (at most 10) and enpassant captures are
+			generated and tested.
+
+			Returns: The number of moves GenerateLegalMoves() would generate.
+		*/
+		int CountLegalMoves();
+
+		/*
+			Determines if a move from elsewhere (e.g. the hash table, a killer move or an opening
+			book) is pseudo legal in the current position, i.e. it is one of the moves
+			GenerateMoves(MoveGenerationAll, ...) would generate, flags included. Only the
+			squares the move uses are tested so no moves are generated. A move that passes
+			can be made with MakeMove().
+
+			move: The move to test, any 16 bit value.
+
+			Returns: True if pseudo legal, false otherwise.
+		*/
+		bool IsPseudoLegal(const Move& move) const;
+
+		/*
+			Determines if a move gives check, without making it. Covers direct checks (including
+			by the promoted piece and by the rook when castling) and discovered checks (including
+			the captured pawn's square for enpassant), using the attack delta table.
+
+			move: A pseudo legal move for the side to move.
+
+			Returns: True if the move gives check, false otherwise.
+		*/
+		bool GivesCheck(const Move& move) const;
+
+		/*
+			Static exchange evaluation. Plays out the captures on the move's destination square,
+			each side capturing with its least valuable piece (including sliders behind pieces
+			that have already captured) and stopping when carrying on would lose material. Uses
+			Piece::GetPieceValue(). The board is not changed.
+
+			move: A pseudo legal move for the side to move, usually a capture.
+
+			Returns: The material the side to move gains (negative if it loses material).
+		*/
+		int SEE(const Move& move) const;
+
+		/*
+			Determines if the static exchange evaluation of a move is at least a threshold, the
+			same as SEE(move) >= threshold but stops as soon as the answer is known. E.g. a
+			threshold of 0 tests that a capture does not lose material.
+
+			move: A pseudo legal move for the side to move, usually a capture.
+			threshold: The value to test against.
+
+			Returns: True if SEE(move) >= threshold, false otherwise.
+		*/
+		bool SeeGreaterOrEqual(const Move& move, const int threshold) const;
+
 		/*
 			Makes the specified move. Only pass a move returned by GeneratePseudoLegalMoves()
-			to avoid undefined behaviour.
+			(or one IsPseudoLegal() accepts) to avoid undefined behaviour.
 
 			move: The move.
 
 			Returns: True if the move is ok, false if it is not valid (i.e.
-					 leave the king in check or castling not possible).
+					 leave the king in check or castling not possible) or the unmake
+					 stack is full.
 		*/
 		bool MakeMove(const Move& move);
 
+		/*
+			Makes the specified move without testing if it leaves the king in check. Only pass
+			a move returned by GenerateLegalMoves() to avoid undefined behaviour.
+
+			move: The move.
+
+			Returns: True if the move was made, false if the unmake stack is full (i.e.
+					 FixedUnmakeMoveListCapacity moves are already made).
+		*/
+		bool MakeLegalMove(const Move& move);
+
+		/*
+			Colour templated versions of the methods above. Us is the side to move (Piece::PieceColourWhite
+			or Piece::PieceColourBlack) and must be the same as GetColourToMove(). Everything that depends
+			on the side to move (pawn directions, promotion rank, king square, castling squares) is fixed
+			at compile time. A search can alternate Us each ply so the side to move is only tested once,
+			the methods above test it and call these.
+		*/
+		template <int Us>
+		void GeneratePseudoLegalMoves(Move* moves, int& moveCount);
+		template <int Us>
+		void GenerateMoves(int generationType, Move* moves, int& moveCount);
+		template <int Us>
+		void GenerateCaptures(Move* moves, int& moveCount);
+		template <int Us>
+		void GenerateEvasions(Move* moves, int& moveCount);
+		template <int Us>
+		void GenerateLegalMoves(Move* moves, int& moveCount);
+		template <int Us>
+		int CountLegalMoves();
+		template <int Us>
+		bool MakeMove(const Move& move);
+		template <int Us>
+		bool MakeLegalMove(const Move& move);
+
 		/*
 			Unmakes a move. Does no validation so do NOT call when there are
 			no moves to unmake, will cause an overflow and thus undefined
@@ -80,6 +257,30 @@ namespace ATHENAZEROENG
 		*/
 		void UnMakeMove();
 
+		/*
+			Makes a null move, i.e. passes the move to the other side (e.g. for null move
+			pruning). Only the state and key change, the pieces are not touched. Do not call
+			when the side to move is in check. Undo with UnMakeNullMove().
+
+			Returns: True if the null move was made, false if the unmake stack is full.
+		*/
+		bool MakeNullMove();
+
+		/*
+			Unmakes a null move. Only call when the last move made was MakeNullMove().
+		*/
+		void UnMakeNullMove();
+
+		/*
+			Determines if the current position has occurred before, using the keys held on the
+			unmake stack (the game moves followed by the search path). Only the last HalfMoveClock
+			plies are scanned, and only every other one as the side to move must be the same.
+			A null move ends the scan as positions before it are not reachable by real moves.
+
+			Returns: True if the position is a repetition, false otherwise.
+		*/
+		bool IsRepetition() const;
+
 		/*
 			Gets the FEN (ForsythEdwards Notation) for the current position.
 
@@ -88,7 +289,42 @@ namespace ATHENAZEROENG
 		std::string GetPositionAsFen();
 
 		/*
-			Sets the positon from the FEN (ForsythEdwards Notation) for a position.
+			The buffer length needed by WritePositionAsFen(). The longest FEN is 64 pieces, 7 rank
+			separators and " w KQkq e3 65535 65535", plus a null terminator.
+		*/
+		static constexpr size_t FenBufferLength = 96;
+
+		//The largest half move clock or full move number that can be stored in BoardState
+		static constexpr int MaxMoveCounter = 65535;
+
+		//The largest half move clock or full move number a position can be set with. Each move
+		//adds at most 1 to each and at most FixedUnmakeMoveListCapacity moves can follow, so
+		//the counters never wrap past MaxMoveCounter.
+		static constexpr int MaxSetMoveCounter = MaxMoveCounter - FixedUnmakeMoveListCapacity;
+
+		/*
+			Writes the FEN (ForsythEdwards Notation) for the current position followed by a null
+			terminator. Does not allocate, e.g. for writing millions of training records. Use a
+			char array or std::array<char, FenBufferLength>.
+
+			buffer: At least FenBufferLength in length.
+			Returns: The number of characters written, excluding the null terminator.
+		*/
+		size_t WritePositionAsFen(char* buffer) const;
+
+		/*
+			Finds the legal move given in the standard format (e.g. e2e4, e7e8q, e1g1 for castling)
+			as written by Move::WriteMoveAsStandardFormat().
+
+			text: The move, need not be null terminated.
+			length: The length of the move text.
+			Returns: The move, or the null move if the text is not a legal move in this position.
+		*/
+		Move ParseMove(const char* text, const size_t length);
+
+		/*
+			Sets the positon from the FEN (ForsythEdwards Notation) for a position. The
+			half move clock and full move number must be no more than MaxSetMoveCounter.
 
 			fen: The FEN positon to set.
 
@@ -97,13 +333,65 @@ namespace ATHENAZEROENG
 		*/
 		bool SetPositionFromFen(std::string fen);
 
+		/*
+			Sets the position from FEN held in a buffer (e.g. part of a memory mapped file). Does
+			not allocate, so is the one to use when loading many positions.
+
+			fen: The FEN position, need not be null terminated.
+			length: The length of the FEN.
+			validate: True to check the position as SetPositionFromFen(std::string) does. False
+					  skips the check (one king each, no pawns on the first or last rank, the side
+					  not to move not in check, corrected castling and enpassant) so only pass
+					  false for trusted positions, e.g. ones written by GetPositionAsFen().
+
+			Returns: True if valid, false otherwise. If false is returned then the game will be set to the start
+					 of a new game using the standard chess starting position.
+		*/
+		bool SetPositionFromFen(const char* fen, const size_t length, const bool validate);
+
+		/*
+			Sets the position from EPD (Extended Position Description). The first four fields are
+			the same as FEN, the operations that follow (e.g. "bm e4; id ...") are ignored. The
+			half move clock is set to 0 and the full move number to 1.
+
+			epd: The EPD, need not be null terminated.
+			length: The length of the EPD.
+			validate: See SetPositionFromFen(const char*, size_t, bool).
+
+			Returns: True if valid, false otherwise. If false is returned then the game will be set to the start
+					 of a new game using the standard chess starting position.
+		*/
+		bool SetPositionFromEpd(const char* epd, const size_t length, const bool validate);
+
+		/*
+			Packs the position into 32 bytes (see PackedPosition), e.g. for datasets and caches.
+
+			packed: Set to the position.
+			Returns: True on success, false if there are more than PackedPosition::MaxPieces
+					 pieces (only possible in a position set up from FEN).
+		*/
+		bool GetPackedPosition(PackedPosition& packed) const;
+
+		/*
+			Sets the position from a packed position. The exact reverse of GetPackedPosition(),
+			but like FEN the move counters must be no more than MaxSetMoveCounter.
+
+			packed: The packed position.
+			validate: See SetPositionFromFen(const char*, size_t, bool). Positions packed from a
+					  Board are already valid so can skip the check.
+
+			Returns: True if valid, false otherwise. If false is returned then the game will be set to the start
+					 of a new game using the standard chess starting position.
+		*/
+		bool SetPositionFromPacked(const PackedPosition& packed, const bool validate);
+
 		/*
 			Gets the current colour to move.
 			Piece::PieceColourWhite or Piece::PieceColourBlack.
 		*/
 		inline int GetColourToMove() const
 		{
-			return g_colourToMove;
+			return g_state.ColourToMove;
 		}
 
 		/*
@@ -112,7 +400,7 @@ namespace ATHENAZEROENG
 		*/
 		inline bool GetCanWhiteCastleKingSide() const
 		{
-			return g_canWhiteCastleKingSide;
+			return (g_state.CastlingRights & BoardState::CastleWhiteKingSide) != 0;
 		}
 
 		/*
@@ -121,7 +409,7 @@ namespace ATHENAZEROENG
 		*/
 		inline bool GetCanWhiteCastleQueenSide() const
 		{
-			return g_canWhiteCastleQueenSide;
+			return (g_state.CastlingRights & BoardState::CastleWhiteQueenSide) != 0;
 		}
 
 		/*
@@ -130,7 +418,7 @@ namespace ATHENAZEROENG
 		*/
 		inline bool GetCanBlackCastleKingSide() const
 		{
-			return g_canBlackCastleKingSide;
+			return (g_state.CastlingRights & BoardState::CastleBlackKingSide) != 0;
 		}
 
 		/*
@@ -139,7 +427,7 @@ namespace ATHENAZEROENG
 		*/
 		inline bool GetCanBlackCastleQueenSide() const
 		{
-			return g_canBlackCastleQueenSide;
+			return (g_state.CastlingRights & BoardState::CastleBlackQueenSide) != 0;
 		}
 
 		/*
@@ -147,7 +435,7 @@ namespace ATHENAZEROENG
 		*/
 		inline BoardIndex0x88 GetWhiteKingLocation0x88() const
 		{
-			return g_WhiteKingLocation0x88;
+			return g_state.WhiteKingLocation0x88;
 		}
 
 		/*
@@ -155,7 +443,7 @@ namespace ATHENAZEROENG
 		*/
 		inline BoardIndex0x88 GetBlackKingLocation0x8() const
 		{
-			return g_BlackKingLocation0x88;
+			return g_state.BlackKingLocation0x88;
 		}
 
 		/*
@@ -164,7 +452,7 @@ namespace ATHENAZEROENG
 		*/
 		inline BoardIndex0x88 GetEnpassantTargetSquare() const
 		{
-			return g_EnpassantTargetSquare;
+			return g_state.EnpassantTargetSquare;
 		}
 
 		/*
@@ -172,7 +460,7 @@ namespace ATHENAZEROENG
 		*/
 		inline int GetHalfMoveClock() const
 		{
-			return g_halfMoveClock;
+			return g_state.HalfMoveClock;
 		}
 
 		/*
@@ -180,7 +468,64 @@ namespace ATHENAZEROENG
 		*/
 		inline int GetFullMoveNumber() const
 		{
-			return g_fullMoveNumber;
+			return g_state.FullMoveNumber;
+		}
+
+		/*
+			Gets the position's Zobrist key. Updated incrementally as moves are made
+			and unmade.
+		*/
+		inline ZobristKey GetKey() const
+		{
+			return g_key;
+		}
+
+		/*
+			Calculates the position's Zobrist key from scratch. Should always equal GetKey(),
+			useful for checking the incremental updates.
+		*/
+		ZobristKey CalculateKey() const;
+
+		/*
+			Gets the Zobrist key of the pawns only (the piece keys of every pawn). Updated
+			incrementally as moves are made and unmade. The key for a pawn structure cache.
+		*/
+		inline ZobristKey GetPawnKey() const
+		{
+			return g_pawnKey;
+		}
+
+		/*
+			Calculates the pawn key from scratch. Should always equal GetPawnKey().
+		*/
+		ZobristKey CalculatePawnKey() const;
+
+		/*
+			Gets the material signature, the count of each piece type for each colour. Updated
+			incrementally as moves are made and unmade. Equal signatures have equal material,
+			so it identifies specialised endgames and insufficient material without a board scan.
+		*/
+		inline MaterialSignature GetMaterialSignature() const
+		{
+			return g_materialSignature;
+		}
+
+		/*
+			Calculates the material signature from scratch. Should always equal GetMaterialSignature().
+		*/
+		MaterialSignature CalculateMaterialSignature() const;
+
+		/*
+			Gets a count from a material signature.
+
+			signature: The material signature.
+			colourIndex: The colour index (Piece::ColourIndexXXX).
+			pieceIndex: The piece index (Piece::PieceIndexXXX), not Piece::PieceIndexNone.
+			Returns: The number of pieces of that type and colour.
+		*/
+		static constexpr int GetMaterialCount(const MaterialSignature signature, const int colourIndex, const int pieceIndex)
+		{
+			return static_cast<int>((signature >> GetMaterialShift(colourIndex, pieceIndex)) & MaterialCountMask);
 		}
 
 		/*
@@ -201,7 +546,7 @@ namespace ATHENAZEROENG
 		*/
 		inline int GetSquarePieceType(BoardIndex0x88 square) const
 		{
-			return g_board[square].PieceType;
+			return Piece::GetPackedType(g_board[square]);
 		}
 
 		/*
@@ -210,6 +555,7 @@ namespace ATHENAZEROENG
 			Returns one of;
 				* PieceColourWhite
 				* PieceColourBlack
+				* 0 if the square is empty
 
 			Does no validation.
 
@@ -217,7 +563,56 @@ namespace ATHENAZEROENG
 		*/
 		inline int GetSquarePieceColour(BoardIndex0x88 square) const
 		{
-			return g_board[square].PieceColour;
+			return Piece::GetPackedColour(g_board[square]);
+		}
+
+		/*
+			Gets the pieces of one colour that attack a square. Worked out from the piece
+			bitboards with the magic bitboard tables, a few lookups whatever the position.
+
+			square: The attacked square (0x88).
+			attackingColour: Piece::PieceColourWhite or Piece::PieceColourBlack.
+
+			Returns: The squares of the attacking pieces as bitboard squares (see Sq64To0x88()).
+		*/
+		inline Bitboard GetAttackers(BoardIndex0x88 square, int attackingColour) const
+		{
+			return GetAttackersOfIndex(Sq0x88To64(square), Piece::ColourToIndex(attackingColour));
+		}
+
+		/*
+			Gets the number of pieces of one colour that attack a square.
+
+			square: The attacked square (0x88).
+			attackingColour: Piece::PieceColourWhite or Piece::PieceColourBlack.
+		*/
+		inline int GetAttackerCount(BoardIndex0x88 square, int attackingColour) const
+		{
+			return PopCount(GetAttackers(square, attackingColour));
+		}
+
+		/*
+			Determines if the side to move is in check.
+		*/
+		inline bool IsInCheck() const
+		{
+			const int us = g_state.ColourToMove;
+			const BoardIndex0x88 kingSquare = us == Piece::PieceColourWhite ? g_state.WhiteKingLocation0x88 : g_state.BlackKingLocation0x88;
+			return IsSquareAttacked(kingSquare, us == Piece::PieceColourWhite ? Piece::PieceColourBlack : Piece::PieceColourWhite);
+		}
+
+		/*
+			Determines if a square is attacked. See GetAttackers().
+
+			square: The attacked square.
+			attackingColour: The side attacking. Must be one of:
+				* Piece::PieceColourWhite
+				* Piece::PieceColourBlack
+			Returns: True if the square is attacked, false otherwise.
+		*/
+		inline bool IsSquareAttacked(const BoardIndex0x88 square, const int attackingColour) const
+		{
+			return GetAttackers(square, attackingColour) != 0;
 		}
 	private:
 		//0-136 (136 = 0x88), so Null0x88Square actually exists in the array - Avoids some branch statements
@@ -262,43 +657,175 @@ namespace ATHENAZEROENG
 		static constexpr int BoardDirTowardsAttackingBlackPawn1 = 17;
 		static constexpr int BoardDirTowardsAttackingBlackPawn2 = 15;
 
-		Piece g_board[BoardArrayLength];
+		//The most pieces of one type a side can have (e.g. 2 knights plus 8 promoted pawns)
+		static constexpr int MaxPiecesPerType = 10;
+
+		//The most squares that resolve a single check (the checking piece plus the squares up to the king)
+		static constexpr int MaxCheckBlockSquares = 7;
+
+		//The most pieces that can be pinned at once (one per direction from the king)
+		static constexpr int MaxPinnedPieces = 8;
+
+		//The most legal king moves (8 steps plus 2 castling moves)
+		static constexpr int MaxKingMoves = 10;
 
 		/*
-			The current side (colour) to move.
-			* Piece::PieceColourWhite
-			* Piece::PieceColourBlack
+			Side to move, castling rights, king squares etc. Placed first and followed by the
+			board array so the state and the start of the board share a cache line.
 		*/
-		int g_colourToMove{ Piece::PieceColourWhite };
+		BoardState g_state;
 
-		bool g_canWhiteCastleKingSide{ true };
-		bool g_canWhiteCastleQueenSide{ true };
-		bool g_canBlackCastleKingSide{ true };
-		bool g_canBlackCastleQueenSide{ true };
+		/*
+			One byte per square (Piece::PieceTypeXXX | Piece::PieceColourXXX), 0 if empty.
+			Testing for an empty square or a piece of a given colour and type is a single compare.
+		*/
+		PackedPiece g_board[BoardArrayLength];
 
-		BoardIndex0x88 g_WhiteKingLocation0x88{ Null0x88Square };
-		BoardIndex0x88 g_BlackKingLocation0x88{ Null0x88Square };
+		//For each occupied square, the index of its piece within its piece list
+		unsigned char g_pieceListIndex[BoardArrayLength];
 
-		BoardIndex0x88 g_EnpassantTargetSquare{ Null0x88Square };
+		/*
+			Piece lists. The squares (0x88) of every piece, grouped by colour then
+			piece type. Indexed by Piece::ColourIndexXXX, Piece::PieceIndexXXX then
+			0 to g_pieceCount - 1. Order within a type is not significant.
+		*/
+		CompactBoardIndex0x88 g_pieceList[2][Piece::PieceTypeCount][MaxPiecesPerType];
 
-		//Starts at zero. Inceremented after every ply, reset to 0 after a pawn move or capture.
-		int g_halfMoveClock{ 0 };
+		//The number of pieces in each piece list
+		int g_pieceCount[2][Piece::PieceTypeCount];
 
-		//Starts at 1 and increments after black's move.
-		int g_fullMoveNumber{ 1 };
+		/*
+			Piece bitboards (bitboard squares, see Sq0x88To64()). The pieces of each type
+			(Piece::PieceIndexXXX) of both colours, and the pieces of each colour
+			(Piece::ColourIndexXXX). Updated as pieces are placed and removed, only a few bits
+			change per move, and used to work out attacks with the magic bitboard tables.
+		*/
+		Bitboard g_pieceBitboards[Piece::PieceTypeCount];
+		Bitboard g_colourBitboards[2];
 
-		UnmakeItem* g_UnmakeList;
+		/*
+			The unmake stack. A fixed size (FixedUnmakeMoveListCapacity) so it never grows,
+			MakeLegalMove() and MakeNullMove() return false when it is full. The key saved in
+			each item is also the position history used by IsRepetition().
+		*/
+		alignas(CacheLineSize) UnmakeItem g_UnmakeList[FixedUnmakeMoveListCapacity];
 		size_t g_UnmakeLength{ 0 };
-		size_t g_UnmakeCapacity{ 0 };
+
+		//The position's Zobrist key
+		ZobristKey g_key{ 0 };
+
+		//The Zobrist key of the pawns only
+		ZobristKey g_pawnKey{ 0 };
+
+		//The count of each piece type for each colour
+		MaterialSignature g_materialSignature{ 0 };
+
+		//Each count in a material signature is 4 bits, enough for 10 pieces of one type
+		static constexpr int MaterialCountBits = 4;
+		static constexpr MaterialSignature MaterialCountMask = 15;
+
+		/*
+			Gets the bit position of a count in a material signature.
+		*/
+		static constexpr int GetMaterialShift(const int colourIndex, const int pieceIndex)
+		{
+			return (colourIndex * Piece::PieceTypeCount + pieceIndex) * MaterialCountBits;
+		}
 
 		/*
-			Records the curret state so it can be undone with UnMakeMove().
+			Gets the amount a piece adds to the material signature.
+		*/
+		static inline MaterialSignature GetMaterialUnit(const PackedPiece piece)
+		{
+			return 1ULL << GetMaterialShift(
+				Piece::ColourToIndex(Piece::GetPackedColour(piece)),
+				Piece::PieceTypeToIndex(Piece::GetPackedType(piece)));
+		}
 
-			move: The move being made.
+		/*
+			Adds a piece to the pawn key and material signature. Used by PlacePiece() and
+			ReplacePiece() so both are updated by make and unmake alike.
+		*/
+		inline void AddToPawnAndMaterialKeys(const BoardIndex0x88 square, const PackedPiece piece)
+		{
+			if (Piece::GetPackedType(piece) == Piece::PieceTypePawn) g_pawnKey ^= GetPieceKey(piece, square);
+			g_materialSignature += GetMaterialUnit(piece);
+		}
+
+		/*
+			Removes a piece from the pawn key and material signature.
+		*/
+		inline void RemoveFromPawnAndMaterialKeys(const BoardIndex0x88 square, const PackedPiece piece)
+		{
+			if (Piece::GetPackedType(piece) == Piece::PieceTypePawn) g_pawnKey ^= GetPieceKey(piece, square);
+			g_materialSignature -= GetMaterialUnit(piece);
+		}
+
+		/*
+			The 0x88 attack delta table, indexed by (target - source + AttackDeltaOffset).
+			The difference between two 0x88 squares identifies the vector between them, so a
+			single lookup tells which pieces could attack along it and the step to walk.
+		*/
+		static constexpr int AttackDeltaOffset = 0x77;
+		static constexpr int AttackDeltaLength = 0xEF;
+
+		//The piece types (Piece::PieceTypeXXX bits) that can attack along each vector. Pawn
+		//entries also hold the colour (Piece::PieceColourXXX) of the pawns that attack that way.
+		static unsigned char g_attackDeltaPieces[AttackDeltaLength];
+
+		//The single step from the source towards the target, 0 if they do not share a line
+		static signed char g_attackDeltaSteps[AttackDeltaLength];
+
+		/*
+			Builds the attack delta tables. Only does the work on the first call so is safe
+			to call more than once.
+		*/
+		static void InitialiseAttackDeltas();
+
+		/*
+			Fills the attack delta tables. Called once by InitialiseAttackDeltas().
+
+			Returns: True (used to initialise a static).
+		*/
+		static bool BuildAttackDeltas();
+
+		/*
+			Gets the single step (e.g. +16 up, -17 down-left) from one square towards another
+			on the same rank, file or diagonal. 0 if the squares do not share a line.
+		*/
+		static inline int GetAttackStep(const BoardIndex0x88 from, const BoardIndex0x88 to)
+		{
+			return g_attackDeltaSteps[static_cast<int>(to) - static_cast<int>(from) + AttackDeltaOffset];
+		}
+
+		/*
+			Gets the Zobrist key for a piece on a square.
+		*/
+		static inline ZobristKey GetPieceKey(const PackedPiece piece, const BoardIndex0x88 square)
+		{
+			return Zobrist::GetPieceKey(
+				Piece::ColourToIndex(Piece::GetPackedColour(piece)),
+				Piece::PieceTypeToIndex(Piece::GetPackedType(piece)),
+				Sq0x88To64(square));
+		}
+
+		/*
+			Gets the part of the Zobrist key for the castling rights and enpassant square.
+		*/
+		inline ZobristKey GetStateKey() const
+		{
+			ZobristKey key = Zobrist::GetCastlingKey(g_state.CastlingRights);
+			if (g_state.EnpassantTargetSquare != Null0x88Square) key ^= Zobrist::GetEnpassantKey(g_state.EnpassantTargetSquare & 7);
+			return key;
+		}
 
-			Returns: True on success or false on failure.
+		/*
+			Records the curret state so it can be undone with UnMakeMove(). The caller
+			must test the unmake stack has room, see FixedUnmakeMoveListCapacity.
+
+			move: The move being made.
 		*/
-		bool RecordStateToUnMake(const Move& move);
+		void RecordStateToUnMake(const Move& move);
 
 		/*
 			Updates all status values for the board basedon the move.
@@ -308,9 +835,18 @@ namespace ATHENAZEROENG
 				* Castling rights
 				* Enpassant Target Square
 				* King location
+
+			Us: The side making the move (Piece::PieceColourXXX).
 		*/
+		template <int Us>
 		void UpdateStateForMove(const Move& move);
 
+		/*
+			Copies everything from another board apart from the unused part of the unmake stack.
+			A member added to Board must be added here too.
+		*/
+		void CopyFrom(const Board& other);
+
 		/*
 			Ensures the entire board is clear (i.e. contains no pieces).
 		*/
@@ -349,25 +885,46 @@ namespace ATHENAZEROENG
 		*/
 		void SetPieceOnSquare(int file, int rank, int pieceType, int pieceColour);
 
+		/*
+			Rebuilds the piece lists from the board.
+
+			Returns: True on success, false if a side has more than MaxPiecesPerType of
+					 a piece type.
+		*/
+		bool RebuildPieceLists();
+
+		/*
+			Adds the piece on the specified square to its piece list. The board must
+			already contain the piece.
+
+			square: The square (0x88).
+		*/
+		void AddToPieceList(const BoardIndex0x88 square);
+
+		/*
+			Removes the piece on the specified square from its piece list. The board must
+			still contain the piece.
+
+			square: The square (0x88).
+		*/
+		void RemoveFromPieceList(const BoardIndex0x88 square);
+
+		/*
+			Updates the piece lists for a piece moving. The board must still contain the piece
+			on the from square.
+
+			from: The square the piece is moving from (0x88).
+			to: The square the piece is moving to (0x88).
+		*/
+		void MovePieceInList(const BoardIndex0x88 from, const BoardIndex0x88 to);
+
 		/*
 			Adds moves to the move list.
 
 			start: The starting square (0x88).
 			target: The starting square (0x88).
-			promoteTo: The piece to promote to. Must be one of:
-				* Piece::PieceTypeNone
-				* Piece::PieceTypeRook
-				* Piece::PieceTypeKnight
-				* Piece::PieceTypeBishop
-				* Piece::PieceTypeQueen
-			otherSquareToClear: If set when the move is made this
-								square is also cleared. Used for Enpassant
-								captures, set to the pawn that is actually
-								captured.
-			secondaryMoveFrom: The starting square for the secondary move (0x88 format).
-							   Used to move te rook when castling.
-			secondaryMoveTo: The destination square for the secondary move (0x88 format).
-							 Used to move te rook when castling.
+			flags: The Move::MoveFlagXXX value describing the move (capture,
+				   promotion, enpassant, castling etc.).
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -379,10 +936,7 @@ namespace ATHENAZEROENG
 		void AddMove(
 			const BoardIndex0x88 start,
 			const BoardIndex0x88 target,
-			const int promoteTo,
-			const BoardIndex0x88 otherSquareToClear,
-			const BoardIndex0x88 secondaryMoveFrom,
-			const BoardIndex0x88 secondaryMoveTo,
+			const unsigned int flags,
 			Move* moves,
 			int& moveCount);
 
@@ -400,6 +954,7 @@ namespace ATHENAZEROENG
 			maxCount: The maximum number of squares to move. Generally set to
 					  8 for Rook, Bishop and Queen. Set to 1
 					  for King and Knight.
+			generationType: The moves to add, see MoveGenerationXXX.
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -412,6 +967,7 @@ namespace ATHENAZEROENG
 			BoardIndex0x88 start,
 			int direction,
 			int maxCount,
+			int generationType,
 			Move* moves,
 			int& moveCount);
 
@@ -421,6 +977,7 @@ namespace ATHENAZEROENG
 			Always adds for the current colour to move (relevant when it comes to capturing).
 
 			start: The 0x88 position to start at.
+			generationType: The moves to add, see MoveGenerationXXX.
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -429,7 +986,7 @@ namespace ATHENAZEROENG
 					   when this method is called). It is simply modified (i.e. added to)
 					   by this method.
 		*/
-		void AddRookMoves(BoardIndex0x88 start, Move* moves, int& moveCount);
+		void AddRookMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount);
 
 		/*
 			Adds add knight moves.
@@ -437,6 +994,7 @@ namespace ATHENAZEROENG
 			Always adds for the current colour to move (relevant when it comes to capturing).
 
 			start: The 0x88 position to start at.
+			generationType: The moves to add, see MoveGenerationXXX.
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -445,7 +1003,7 @@ namespace ATHENAZEROENG
 					   when this method is called). It is simply modified (i.e. added to)
 					   by this method.
 		*/
-		void AddKnightMoves(BoardIndex0x88 start, Move* moves, int& moveCount);
+		void AddKnightMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount);
 
 		/*
 			Adds add bishop moves.
@@ -453,6 +1011,7 @@ namespace ATHENAZEROENG
 			Always adds for the current colour to move (relevant when it comes to capturing).
 
 			start: The 0x88 position to start at.
+			generationType: The moves to add, see MoveGenerationXXX.
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -461,7 +1020,7 @@ namespace ATHENAZEROENG
 					   when this method is called). It is simply modified (i.e. added to)
 					   by this method.
 		*/
-		void AddBishopMoves(BoardIndex0x88 start, Move* moves, int& moveCount);
+		void AddBishopMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount);
 
 		/*
 			Adds add queen moves.
@@ -469,6 +1028,7 @@ namespace ATHENAZEROENG
 			Always adds for the current colour to move (relevant when it comes to capturing).
 
 			start: The 0x88 position to start at.
+			generationType: The moves to add, see MoveGenerationXXX.
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -477,14 +1037,15 @@ namespace ATHENAZEROENG
 					   when this method is called). It is simply modified (i.e. added to)
 					   by this method.
 		*/
-		void AddQueenMoves(BoardIndex0x88 start, Move* moves, int& moveCount);
+		void AddQueenMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount);
 
 		/*
-			Adds add king moves.
+			Adds add king moves, excluding castling (see AddCastlingMoves()).
 
 			Always adds for the current colour to move (relevant when it comes to capturing).
 
 			start: The 0x88 position to start at.
+			generationType: The moves to add, see MoveGenerationXXX.
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -493,14 +1054,25 @@ namespace ATHENAZEROENG
 					   when this method is called). It is simply modified (i.e. added to)
 					   by this method.
 		*/
-		void AddKingMoves(BoardIndex0x88 start, Move* moves, int& moveCount);
+		void AddKingMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount);
 
 		/*
-			Adds add pawn moves.
+			Adds castling moves. Only the castling rights and the squares between king and rook
+			are tested, check tests are done by MakeMove().
 
-			Always adds for the current colour to move (relevant when it comes to capturing).
+			Us: The side to move (Piece::PieceColourXXX).
+			moves: The move list.
+			moveCount: Added to by this method.
+		*/
+		template <int Us>
+		void AddCastlingMoves(Move* moves, int& moveCount);
 
+		/*
+			Adds add pawn moves.
+
+			Us: The side to move (Piece::PieceColourXXX).
 			start: The 0x88 position to start at.
+			generationType: The moves to add, see MoveGenerationXXX.
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -509,23 +1081,19 @@ namespace ATHENAZEROENG
 					   when this method is called). It is simply modified (i.e. added to)
 					   by this method.
 		*/
-		void AddPawnMoves(BoardIndex0x88 start, Move* moves, int& moveCount);
+		template <int Us>
+		void AddPawnMoves(BoardIndex0x88 start, int generationType, Move* moves, int& moveCount);
 
 		/*
 			Adds a pawn move.
 
+			Us: The side to move (Piece::PieceColourXXX). Gives the direction and promotion rank.
 			initial: The initial position. Used for double move. First move this is the same as start. For the second move
 					 it is the original position.
 			start: The starting square (ox88)
-			direction: +16 for white, -16 for black
-			promotionOperator: Used to detect the promotion square.
-							   * Set to 0x70 for white
-							   * Set to 0xF0 for black
-			promotionComparison: Used to detect the promotion square.
-							   * Set to 0x70 for white
-							   * Set to 0x00 to black
 			isOnHomeSquare: True if the pawn is initially on its home square.
 							False otherwise.
+			generationType: The moves to add, see MoveGenerationXXX.
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -534,27 +1102,21 @@ namespace ATHENAZEROENG
 					   when this method is called). It is simply modified (i.e. added to)
 					   by this method.
 		*/
+		template <int Us>
 		void AddPawnAdvance(
 			const BoardIndex0x88 initial,
 			const BoardIndex0x88 start,
-			const int direction,
-			const unsigned int promotionOperator,
-			const unsigned int promotionComparison,
 			bool isOnHomeSquare,
+			int generationType,
 			Move* moves,
 			int& moveCount);
 
 		/*
 			Adds a pawn capture
 
+			Us: The side to move (Piece::PieceColourXXX). Gives the promotion rank.
 			start: The starting square (ox88)
 			direction: +15/+17 for white, -15/-17 for black
-			promotionOperator: Used to detect the promotion square.
-							   * Set to 0x70 for white
-							   * Set to 0xF0 for black
-			promotionComparison: Used to detect the promotion square.
-							   * Set to 0x70 for white
-							   * Set to 0x00 to black
 			moves: An array. Should be at least 238 in length to avoid
 				   potential overflows.
 			moveCount: When the method returns
@@ -563,60 +1125,142 @@ namespace ATHENAZEROENG
 					   when this method is called). It is simply modified (i.e. added to)
 					   by this method.
 		*/
+		template <int Us>
 		void AddPawnCapture(
 			const BoardIndex0x88 start,
 			const int direction,
-			const unsigned int promotionOperator,
-			const unsigned int promotionComparison,
 			Move* moves,
 			int& moveCount);
 
 		/*
-			Determines if the specified square is attacked by a Queen, King or (Rook/Bishop)
+			Finds the pieces checking the side to move's king and the side to move's
+			pieces that are pinned to it.
+
+			Us: The side to move (Piece::PieceColourXXX).
+			kingSquare: The side to move's king square (0x88).
+			checkBlockSquares: Filled with the squares a non-king move must land on to
+							   resolve a single check (the checker and, for a slider,
+							   the squares between it and the king). Should be at least
+							   MaxCheckBlockSquares in length.
+			checkBlockCount: Set to the number of squares in checkBlockSquares.
+			pinnedSquares: Filled with the squares of pinned pieces. Should be at least
+						   MaxPinnedPieces in length.
+			pinDirections: Filled with the direction from the king to each pinned piece.
+			pinnedCount: Set to the number of pinned pieces.
+
+			Returns: The number of pieces giving check (0, 1 or 2).
+		*/
+		template <int Us>
+		int FindChecksAndPins(
+			const BoardIndex0x88 kingSquare,
+			BoardIndex0x88* checkBlockSquares,
+			int& checkBlockCount,
+			BoardIndex0x88* pinnedSquares,
+			int* pinDirections,
+			int& pinnedCount);
 
-			square: The attacked aquare.
-			attackingColour: The side attacking. Must be one of:
-				* Piece::PieceColourWhite
-				* Piece::PieceColourBlack
-			direction: The 0x88 direction of attack.
-			singleDirectionPieceType: Should be Rook ir Bishop.
-									  This method always checks Queen and King (diagonal and straight)
-									  but only checks Rook or Bishop (depending on the direction), as specified by this
-									  parameter. Must be one of:
-										* Piece::PieceTypeRook
-										* Piece::PieceTypeBishop
-			Returns: True if the square is attacked, false otherwise.
+		/*
+			Adds legal king moves (including castling) for the side to move.
+
+			Us: The side to move (Piece::PieceColourXXX).
+			kingSquare: The side to move's king square (0x88).
+			isInCheck: True if the king is in check (castling is not allowed).
+			moves: The move list.
+			moveCount: Added to by this method.
 		*/
-		bool IsSquareAttackedByStraightOrDiagonalAttackingPiece(
-			const BoardIndex0x88 square,
-			const int attackingColour,
-			const int direction,
-			const int singleDirectionPieceType);
+		template <int Us>
+		void AddLegalKingMoves(const BoardIndex0x88 kingSquare, bool isInCheck, Move* moves, int& moveCount);
+
+		/*
+			Gets the king square (0x88) of a colour.
 
-		bool IsSquareAttackedByKnight(
-			const BoardIndex0x88 square,
-			const int attackingColour);
+			Us: The colour (Piece::PieceColourXXX).
+		*/
+		template <int Us>
+		inline BoardIndex0x88 GetKingSquare() const
+		{
+			return Us == Piece::PieceColourWhite ? g_state.WhiteKingLocation0x88 : g_state.BlackKingLocation0x88;
+		}
 
 		/*
-			Determines if a square is attacked by a pawn.
+			Gets the rank a colour's pawns promote on, as the rank bits of a 0x88 square (square & 0x70).
 
-			square: The attacked aquare.
-			attackingColour: The side attacking. Must be one of:
-				* Piece::PieceColourWhite
-				* Piece::PieceColourBlack
-			direction1: First direction towards the attacker from the attacked piece.
-						NOTE: This is the OPPOSITE direction that the piece will attack in.
-			direction2: First direction towards the attacker from the attacked piece.
-						NOTE: This is the OPPOSITE direction that the piece will attack in.
+			Us: The colour (Piece::PieceColourXXX).
+		*/
+		template <int Us>
+		static constexpr unsigned int GetPromotionRank()
+		{
+			return Us == Piece::PieceColourWhite ? 0x70 : 0x00;
+		}
+
+		/*
+			Walks from a square in one direction and gets the first square that will be occupied
+			once a move is made. The squares the move empties (from, the castling rook's
+			square and the enpassant captured pawn) are treated as empty and the squares it
+			fills (to and the castling rook's destination) as occupied.
+
+			start: The square to walk from (not tested).
+			step: The direction to walk.
+			move: The move.
+
+			Returns: The first occupied square or Null0x88Square if the edge of the board is reached.
+		*/
+		BoardIndex0x88 FindFirstPieceAfterMove(const BoardIndex0x88 start, const int step, const Move& move) const;
+
+		/*
+			Gets the material a move captures for static exchange evaluation, including the
+			gain from promoting.
 		*/
-		bool IsAttackedByPawn(
-			const BoardIndex0x88 square,
-			const int attackingColour,
-			const int direction1,
-			const int direction2);
+		int GetSeeCaptureValue(const Move& move) const;
 
 		/*
-			Determines if a square is attacked.
+			Removes a piece from a set of static exchange attackers and adds the slider (if any)
+			behind it that now attacks the target.
+
+			target: The square being captured on.
+			square: The square of the piece being removed.
+			attackers: The attackers of both colours (bitboard squares, see Sq0x88To64()). Updated.
+			removed: The pieces removed so far (bitboard squares). Updated.
+		*/
+		void RemoveSeeAttacker(const BoardIndex0x88 target, const BoardIndex0x88 square, Bitboard& attackers, Bitboard& removed) const;
+
+		/*
+			Finds the least valuable of one colour's static exchange attackers.
+
+			attackers: The attackers of both colours (bitboard squares).
+			colour: The colour (Piece::PieceColourXXX).
+
+			Returns: The attacker's square or Null0x88Square if the colour has no attackers.
+		*/
+		BoardIndex0x88 GetLeastValuableAttacker(const Bitboard attackers, const int colour) const;
+
+		/*
+			Determines if a move by a pinned piece stays on the line through the king and the
+			pinning piece.
+
+			from: The pinned piece's square (0x88).
+			to: The destination square (0x88).
+			pinDirection: The direction from the king to the pinned piece.
+			Returns: True if the move keeps the pin line blocked, false otherwise.
+		*/
+		static inline bool IsOnPinLine(const BoardIndex0x88 from, const BoardIndex0x88 to, const int pinDirection)
+		{
+			if (pinDirection == BoardDirRight || pinDirection == BoardDirLeft)
+			{
+				//Along a rank, no other 0x88 difference is a multiple of 1 within a rank
+				return (from & 0x70) == (to & 0x70);
+			}
+
+			//No single step in another direction (or knight jump) is a multiple of these
+			return (static_cast<int>(to) - static_cast<int>(from)) % pinDirection == 0;
+		}
+
+		/*
+			Determines if a square is attacked without using the piece bitboards. Each of the
+			attacker's pieces is tested with one lookup in the attack delta table, only
+			sliders lined up with the square need the squares between them checking. Used
+			where the board has been changed without updating the bitboards (e.g. the king
+			lifted to test its moves).
 
 			square: The attacked square.
 			attackingColour: The side attacking. Must be one of:
@@ -624,42 +1268,143 @@ namespace ATHENAZEROENG
 				* Piece::PieceColourBlack
 			Returns: True if the square is attacked, false otherwise.
 		*/
-		bool IsSquareAttacked(const BoardIndex0x88 square, const int attackingColour);
+		bool IsSquareAttackedScan(const BoardIndex0x88 square, const int attackingColour);
+
+		/*
+			Gets the pieces of one colour that attack a square, see GetAttackers().
+
+			sq64: The attacked square.
+			attackingColourIndex: The side attacking (Piece::ColourIndexXXX).
+			Returns: The attacking pieces.
+		*/
+		inline Bitboard GetAttackersOfIndex(const BoardIndex64 sq64, const int attackingColourIndex) const
+		{
+			const Bitboard occupancy = g_colourBitboards[Piece::ColourIndexWhite] | g_colourBitboards[Piece::ColourIndexBlack];
+			const Bitboard queens = g_pieceBitboards[Piece::PieceIndexQueen];
+
+			return g_colourBitboards[attackingColourIndex] & (
+				(BitboardAttacks::GetKnightAttacks(sq64) & g_pieceBitboards[Piece::PieceIndexKnight]) |
+				//A pawn attacks the square if a pawn of the other colour on the square would attack it
+				(BitboardAttacks::GetPawnAttacks(attackingColourIndex ^ 1, sq64) & g_pieceBitboards[Piece::PieceIndexPawn]) |
+				(BitboardAttacks::GetKingAttacks(sq64) & g_pieceBitboards[Piece::PieceIndexKing]) |
+				(BitboardAttacks::GetBishopAttacks(sq64, occupancy) & (g_pieceBitboards[Piece::PieceIndexBishop] | queens)) |
+				(BitboardAttacks::GetRookAttacks(sq64, occupancy) & (g_pieceBitboards[Piece::PieceIndexRook] | queens)));
+		}
+
+		/*
+			Rebuilds the piece bitboards from the pieces on the board.
+		*/
+		void RebuildPieceBitboards();
+
+		/*
+			Adds a piece to the piece bitboards, or removes it if it has already been added
+			(the bits are toggled).
+
+			square: The square of the piece (0x88).
+			piece: The piece.
+		*/
+		inline void TogglePieceBitboards(const BoardIndex0x88 square, const PackedPiece piece)
+		{
+			const Bitboard squareBit = SquareBitboard(Sq0x88To64(square));
+			g_pieceBitboards[Piece::PieceTypeToIndex(Piece::GetPackedType(piece))] ^= squareBit;
+			g_colourBitboards[Piece::ColourToIndex(Piece::GetPackedColour(piece))] ^= squareBit;
+		}
+
+		/*
+			Places a piece on an empty square, updating the piece bitboards.
+		*/
+		void PlacePiece(const BoardIndex0x88 square, const PackedPiece piece);
+
+		/*
+			Removes the piece from an occupied square, updating the piece bitboards.
+		*/
+		void ClearPiece(const BoardIndex0x88 square);
+
+		/*
+			Replaces the piece on an occupied square (e.g. a capture), updating the piece bitboards.
+		*/
+		void ReplacePiece(const BoardIndex0x88 square, const PackedPiece piece);
 
 		/*
 			Processes the field section of a FEN (ForsythEdwards Notation) position.
 
 			fields: The fields portion of the FEN string.
+			length: The length of the fields.
 			Returns: True on success or false pn failure.
 		*/
-		bool ProcessFenFields(const std::string& fields);
+		bool ProcessFenFields(const char* fields, const size_t length);
 
 		/*
-			Checks if the position is valid.
+			Sets the position from FEN or EPD. Sets the start of a new game if not valid.
+
+			text: The FEN or EPD.
+			length: The length of the text.
+			hasMoveCounters: True for FEN (optional half move clock and full move number follow
+							 the enpassant square), false for EPD.
+			validate: True to call ValidatePosition().
+			Returns: True if valid, false otherwise.
+		*/
+		bool SetPositionFromText(const char* text, const size_t length, const bool hasMoveCounters, const bool validate);
 
-			Checks the following:
-				* There is one King per side
-				* No pawns exist on ranks 1 or 8
-				* The side not on move is not in check
+		/*
+			Completes setting a position. Sets the keys, or the start of a new game if not valid.
+
+			isValid: True if the position was set and is valid.
+			Returns: isValid.
 		*/
-		bool ValidatePosition();
+		bool CompleteSetPosition(const bool isValid);
+
+		/*
+			Sets the board and state from a packed position, leaving them part set on failure.
+			See SetPositionFromPacked().
+		*/
+		bool UnpackPosition(const PackedPosition& packed, const bool validate);
+
+		/*
+			Parses FEN or EPD into the board and state, leaving them part set on failure. See
+			SetPositionFromText().
+		*/
+		bool ParsePosition(const char* text, const size_t length, const bool hasMoveCounters, const bool validate);
 
 		/*
-			Returns true if the specified side is in check.
+			Finds the next space separated field.
 
-			colour: The colour to check.
-			Returns: True if in check, false otherwise.
+			position: Where to start, moved past the field.
+			end: The end of the text.
+			field: Set to the start of the field.
+			fieldLength: Set to the length of the field.
+			Returns: True if a field was found, false at the end of the text.
 		*/
-		bool IsInCheck(int colour);
+		static bool NextFenField(const char*& position, const char* const end, const char*& field, size_t& fieldLength);
 
 		/*
-			Increases the unmake move list capacity.
+			Parses a move counter field.
+
+			field: The field.
+			fieldLength: The length of the field.
+			minimum: The smallest value allowed.
+			value: Set to the value.
+			Returns: True if the field is a number from minimum to MaxSetMoveCounter, false otherwise.
+		*/
+		static bool ParseFenNumber(const char* field, const size_t fieldLength, const int minimum, int& value);
 
-			newCapacity: The new capacity. Setting this to the same (or less) than the current capacity results
-					 in undefined behaviour.
-			Returns: True on success or false on failure
+		/*
+			Determines if a character separates FEN fields.
 		*/
-		bool IncreaseUnmakeListCapacity(size_t newCapacity);
+		static inline bool IsFenSpace(const char c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+		}
+
+		/*
+			Checks if the position is valid.
+
+			Checks the following:
+				* There is one King per side
+				* No pawns exist on ranks 1 or 8
+				* The side not on move is not in check
+		*/
+		bool ValidatePosition();
 	};
 }
 
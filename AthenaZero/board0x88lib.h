@@ -25,7 +25,7 @@
 #include "movelib.h"
 
 #include <string>
-#include <sstream>
+#include <cstddef>
 
 namespace ATHENAZEROENG
 {
@@ -119,26 +119,58 @@ namespace ATHENAZEROENG
 		Converts a text square (e.g. e4) to the 0x88 version or returns
 		Null0x88Square if the square is not valid.
 
-		move: The square (e.g. e4).
+		square: The square (e.g. e4), need not be null terminated.
+		length: The length of the square text.
 		Returns: The 0x88 square or Null0x88Square on error.
 	*/
-	inline BoardIndex0x88 TextSquareTo0x88(std::string square)
+	inline BoardIndex0x88 TextSquareTo0x88(const char* square, const size_t length)
 	{
-		if (square.size() != 2) return Null0x88Square;
+		if (length != 2) return Null0x88Square;
 		char file = square[0];
 		char rank = square[1];
 		int file07 = CharacterToFile(file);
 		if (file07 == -1) return Null0x88Square;
 
-		//TODO: OK - Make a library function
 		if (rank < '1' || rank > '8') return Null0x88Square;
-		std::stringstream ss;
-		ss << rank;
-		int rank07 = std::stoi(ss.str()) - 1;
+		int rank07 = rank - '1';
 
 		return FileRankTo0x88(file07, rank07);
 	}
 
+	/*
+		Converts a text square (e.g. e4) to the 0x88 version or returns
+		Null0x88Square if the square is not valid.
+
+		move: The square (e.g. e4).
+		Returns: The 0x88 square or Null0x88Square on error.
+	*/
+	inline BoardIndex0x88 TextSquareTo0x88(const std::string& square)
+	{
+		return TextSquareTo0x88(square.data(), square.size());
+	}
+
+	//The buffer length needed by WriteTextSquare(), the square plus a null terminator
+	constexpr size_t TextSquareBufferLength = 3;
+
+	/*
+		Writes an 0x88 square as a text square (e.g. e4) followed by a null terminator.
+
+		square: The 0x88 square.
+		buffer: At least TextSquareBufferLength in length.
+		Returns: The number of characters written, excluding the null terminator. 0 on error.
+	*/
+	inline size_t WriteTextSquare(BoardIndex0x88 square, char* buffer)
+	{
+		buffer[0] = '\0';
+		if (!Is0x88SquareValid(square)) return 0;
+
+		buffer[0] = static_cast<char>('a' + From0x88ToFile(square));
+		buffer[1] = static_cast<char>('1' + From0x88ToRank(square));
+		buffer[2] = '\0';
+
+		return 2;
+	}
+
 	/*
 		Converts an 0x88 square to a text square (e.g. e4). Returns
 		"" on error.
@@ -148,17 +180,10 @@ namespace ATHENAZEROENG
 	*/
 	inline std::string Sq0x88ToTextSquare(BoardIndex0x88 square)
 	{
-		if (!Is0x88SquareValid(square)) return "";
-		int file07 = From0x88ToFile(square);
-		int rank07 = From0x88ToRank(square);
-
-		char file = FileToCharacter(file07);
-		if (file == '-') return "";
-
-		std::stringstream ss;
-		ss << file << (rank07 + 1);
+		char buffer[TextSquareBufferLength];
+		const size_t length = WriteTextSquare(square, buffer);
 
-		return ss.str();
+		return std::string(buffer, length);
 	}
 }
 
@@ -0,0 +1,751 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains a bitboard based alternative to the 0x88 Board. It has the
+	same move generation, make and unmake surface as Board so it can be used
+	anywhere Board is (e.g. perft).
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+
+#include "boardbitboard.h"
+#include "board.h"
+#include "move.h"
+#include "piece.h"
+#include "bitboardlib.h"
+#include "bitboardattacks.h"
+#include "board0x88lib.h"
+
+namespace ATHENAZEROENG
+{
+	const unsigned int BoardBitboard::CastlingRightsMask[64] =
+	{
+		//a1 = ~WQ, e1 = ~(WK | WQ), h1 = ~WK
+		13, 15, 15, 15, 12, 15, 15, 14,
+		15, 15, 15, 15, 15, 15, 15, 15,
+		15, 15, 15, 15, 15, 15, 15, 15,
+		15, 15, 15, 15, 15, 15, 15, 15,
+		15, 15, 15, 15, 15, 15, 15, 15,
+		15, 15, 15, 15, 15, 15, 15, 15,
+		15, 15, 15, 15, 15, 15, 15, 15,
+		//a8 = ~BQ, e8 = ~(BK | BQ), h8 = ~BK
+		7, 15, 15, 15, 3, 15, 15, 11
+	};
+
+	BoardBitboard::BoardBitboard()
+	{
+		BitboardAttacks::Initialise();
+
+		//Setup the initial position
+		NewGame();
+	}
+
+	void BoardBitboard::NewGame()
+	{
+		ClearBoard();
+
+		static constexpr int backRank[8] =
+		{
+			Piece::PieceIndexRook,
+			Piece::PieceIndexKnight,
+			Piece::PieceIndexBishop,
+			Piece::PieceIndexQueen,
+			Piece::PieceIndexKing,
+			Piece::PieceIndexBishop,
+			Piece::PieceIndexKnight,
+			Piece::PieceIndexRook
+		};
+
+		for (BoardIndex64 file = 0; file < 8; ++file)
+		{
+			SetPieceOnSquare(file, backRank[file], Piece::ColourIndexWhite);
+			SetPieceOnSquare(8 + file, Piece::PieceIndexPawn, Piece::ColourIndexWhite);
+			SetPieceOnSquare(48 + file, Piece::PieceIndexPawn, Piece::ColourIndexBlack);
+			SetPieceOnSquare(56 + file, backRank[file], Piece::ColourIndexBlack);
+		}
+
+		g_position.ColourToMove = { Piece::ColourIndexWhite };
+		g_position.CastlingRights = { CastleAll };
+		g_position.EnpassantTargetSquare = { NullSquare64 };
+		g_position.HalfMoveClock = { 0 };
+		g_position.FullMoveNumber = { 1 };
+		g_UnmakeLength = { 0 };
+		g_positionHistoryLength = { 0 };
+	}
+
+	void BoardBitboard::GeneratePseudoLegalMoves(Move* moves, int& moveCount)
+	{
+		moveCount = 0;
+
+		const Bitboard own = g_position.Colours[g_position.ColourToMove];
+		const Bitboard occupancy = own | g_position.Colours[g_position.ColourToMove ^ 1];
+		const Bitboard targets = ~own;
+
+		AddPawnMoves(g_position.Pieces[Piece::PieceIndexPawn] & own, ~0ULL, moves, moveCount);
+		AddEnpassantMoves(moves, moveCount);
+
+		Bitboard pieces = g_position.Pieces[Piece::PieceIndexKnight] & own;
+		while (pieces != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pieces);
+			AddMovesToTargets(from, BitboardAttacks::GetKnightAttacks(from) & targets, moves, moveCount);
+		}
+
+		pieces = g_position.Pieces[Piece::PieceIndexBishop] & own;
+		while (pieces != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pieces);
+			AddMovesToTargets(from, BitboardAttacks::GetBishopAttacks(from, occupancy) & targets, moves, moveCount);
+		}
+
+		pieces = g_position.Pieces[Piece::PieceIndexRook] & own;
+		while (pieces != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pieces);
+			AddMovesToTargets(from, BitboardAttacks::GetRookAttacks(from, occupancy) & targets, moves, moveCount);
+		}
+
+		pieces = g_position.Pieces[Piece::PieceIndexQueen] & own;
+		while (pieces != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pieces);
+			AddMovesToTargets(from, BitboardAttacks::GetQueenAttacks(from, occupancy) & targets, moves, moveCount);
+		}
+
+		pieces = g_position.Pieces[Piece::PieceIndexKing] & own;
+		while (pieces != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pieces);
+			AddMovesToTargets(from, BitboardAttacks::GetKingAttacks(from) & targets, moves, moveCount);
+		}
+
+		AddCastlingMoves(moves, moveCount);
+	}
+
+	void BoardBitboard::GenerateLegalMoves(Move* moves, int& moveCount)
+	{
+		moveCount = 0;
+
+		const int us = g_position.ColourToMove;
+		const int them = us ^ 1;
+		const Bitboard own = g_position.Colours[us];
+		const Bitboard enemy = g_position.Colours[them];
+		const Bitboard occupancy = own | enemy;
+		const BoardIndex64 kingSquare = LeastSignificantSquare(g_position.Pieces[Piece::PieceIndexKing] & own);
+
+		const Bitboard checkers = GetAttackers(kingSquare, occupancy, them);
+
+		//King moves, tested without the king on the board so it cannot step back along a checking ray
+		const Bitboard occupancyWithoutKing = occupancy ^ SquareBitboard(kingSquare);
+		Bitboard kingTargets = BitboardAttacks::GetKingAttacks(kingSquare) & ~own;
+		while (kingTargets != 0)
+		{
+			BoardIndex64 target = PopLeastSignificantSquare(kingTargets);
+			if (GetAttackers(target, occupancyWithoutKing, them) == 0)
+			{
+				AddMove(kingSquare, target, (enemy & SquareBitboard(target)) != 0 ? Move::MoveFlagCapture : Move::MoveFlagQuiet, moves, moveCount);
+			}
+		}
+
+		//Only the king can move out of double check
+		if (PopCount(checkers) > 1) return;
+
+		//Non-king moves must capture the checker or block
+		Bitboard checkMask = ~0ULL;
+		if (checkers != 0)
+		{
+			checkMask = checkers | BitboardAttacks::GetBetween(kingSquare, LeastSignificantSquare(checkers));
+		}
+
+		//Pinned pieces. Slider rays are found ignoring own pieces, a single own piece between is pinned.
+		const Bitboard queens = g_position.Pieces[Piece::PieceIndexQueen];
+		Bitboard snipers =
+			(BitboardAttacks::GetRookAttacks(kingSquare, enemy) & (g_position.Pieces[Piece::PieceIndexRook] | queens) & enemy) |
+			(BitboardAttacks::GetBishopAttacks(kingSquare, enemy) & (g_position.Pieces[Piece::PieceIndexBishop] | queens) & enemy);
+		Bitboard pinned = 0;
+		while (snipers != 0)
+		{
+			Bitboard between = BitboardAttacks::GetBetween(kingSquare, PopLeastSignificantSquare(snipers)) & occupancy;
+			if (PopCount(between) == 1) pinned |= between & own;
+		}
+
+		const Bitboard targets = ~own & checkMask;
+
+		//Pawns, pinned ones one at a time as each has its own pin line
+		const Bitboard pawns = g_position.Pieces[Piece::PieceIndexPawn] & own;
+		AddPawnMoves(pawns & ~pinned, checkMask, moves, moveCount);
+		Bitboard pinnedPawns = pawns & pinned;
+		while (pinnedPawns != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pinnedPawns);
+			AddPawnMoves(SquareBitboard(from), checkMask & BitboardAttacks::GetLine(kingSquare, from), moves, moveCount);
+		}
+
+		//Enpassant removes two pawns from a rank so is rare and awkward to test for pins, make the move to test
+		int firstMove = moveCount;
+		AddEnpassantMoves(moves, moveCount);
+		int legalCount = firstMove;
+		for (int i = firstMove; i < moveCount; ++i)
+		{
+			if (MakeMove(moves[i]))
+			{
+				UnMakeMove();
+				moves[legalCount] = moves[i];
+				++legalCount;
+			}
+		}
+		moveCount = legalCount;
+
+		//Pinned knights can never move
+		Bitboard pieces = g_position.Pieces[Piece::PieceIndexKnight] & own & ~pinned;
+		while (pieces != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pieces);
+			AddMovesToTargets(from, BitboardAttacks::GetKnightAttacks(from) & targets, moves, moveCount);
+		}
+
+		pieces = g_position.Pieces[Piece::PieceIndexBishop] & own;
+		while (pieces != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pieces);
+			Bitboard pieceTargets = BitboardAttacks::GetBishopAttacks(from, occupancy) & targets;
+			if ((pinned & SquareBitboard(from)) != 0) pieceTargets &= BitboardAttacks::GetLine(kingSquare, from);
+			AddMovesToTargets(from, pieceTargets, moves, moveCount);
+		}
+
+		pieces = g_position.Pieces[Piece::PieceIndexRook] & own;
+		while (pieces != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pieces);
+			Bitboard pieceTargets = BitboardAttacks::GetRookAttacks(from, occupancy) & targets;
+			if ((pinned & SquareBitboard(from)) != 0) pieceTargets &= BitboardAttacks::GetLine(kingSquare, from);
+			AddMovesToTargets(from, pieceTargets, moves, moveCount);
+		}
+
+		pieces = g_position.Pieces[Piece::PieceIndexQueen] & own;
+		while (pieces != 0)
+		{
+			BoardIndex64 from = PopLeastSignificantSquare(pieces);
+			Bitboard pieceTargets = BitboardAttacks::GetQueenAttacks(from, occupancy) & targets;
+			if ((pinned & SquareBitboard(from)) != 0) pieceTargets &= BitboardAttacks::GetLine(kingSquare, from);
+			AddMovesToTargets(from, pieceTargets, moves, moveCount);
+		}
+
+		//Castling, the king must not start on, pass over or land on an attacked square
+		if (checkers == 0)
+		{
+			firstMove = moveCount;
+			AddCastlingMoves(moves, moveCount);
+			legalCount = firstMove;
+			for (int i = firstMove; i < moveCount; ++i)
+			{
+				const BoardIndex64 to = Sq0x88To64(moves[i].GetMoveTo());
+				if (!IsSquareAttacked((kingSquare + to) / 2, them) && !IsSquareAttacked(to, them))
+				{
+					moves[legalCount] = moves[i];
+					++legalCount;
+				}
+			}
+			moveCount = legalCount;
+		}
+	}
+
+	bool BoardBitboard::MakeMove(const Move& move)
+	{
+		const int us = g_position.ColourToMove;
+		const int them = us ^ 1;
+
+		if (move.IsCastling())
+		{
+			//Cannot castle out of or through check. Landing in check is tested below.
+			const BoardIndex64 from = Sq0x88To64(move.GetMoveFrom());
+			const BoardIndex64 to = Sq0x88To64(move.GetMoveTo());
+			if (IsSquareAttacked(from, them)) return false;
+			if (IsSquareAttacked((from + to) / 2, them)) return false;
+		}
+
+		if (!MakeLegalMove(move)) return false;
+
+		//Cannot move into or leave in check
+		BoardIndex64 kingSquare = LeastSignificantSquare(g_position.Pieces[Piece::PieceIndexKing] & g_position.Colours[us]);
+		if (IsSquareAttacked(kingSquare, them))
+		{
+			UnMakeMove();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool BoardBitboard::MakeLegalMove(const Move& move)
+	{
+		const int us = g_position.ColourToMove;
+		const int them = us ^ 1;
+
+		const BoardIndex64 from = Sq0x88To64(move.GetMoveFrom());
+		const BoardIndex64 to = Sq0x88To64(move.GetMoveTo());
+
+		const int movedPieceIndex = GetPieceIndexOnSquare(from);
+		int capturedPieceIndex = Piece::PieceIndexNone;
+		if (move.IsEnpassant())
+		{
+			capturedPieceIndex = Piece::PieceIndexPawn;
+		}
+		else if ((g_position.Colours[them] & SquareBitboard(to)) != 0)
+		{
+			capturedPieceIndex = GetPieceIndexOnSquare(to);
+		}
+
+		// *** Record state to unmake *** \\
+
+		if (g_useCopyMake)
+		{
+			if (g_positionHistoryLength == FixedUnmakeMoveListCapacity) return false;
+
+			g_positionHistory[g_positionHistoryLength] = g_position;
+			++g_positionHistoryLength;
+		}
+		else
+		{
+			if (g_UnmakeLength == FixedUnmakeMoveListCapacity) return false;
+
+			UnmakeItemBitboard& unmakeItem = g_UnmakeList[g_UnmakeLength];
+			unmakeItem.MoveMade = move;
+			unmakeItem.MovedPieceIndex = movedPieceIndex;
+			unmakeItem.CapturedPieceIndex = capturedPieceIndex;
+			unmakeItem.CastlingRights = g_position.CastlingRights;
+			unmakeItem.EnpassantTargetSquare = g_position.EnpassantTargetSquare;
+			unmakeItem.HalfMoveClock = g_position.HalfMoveClock;
+			unmakeItem.FullMoveNumber = g_position.FullMoveNumber;
+			++g_UnmakeLength;
+		}
+
+		const Bitboard fromBitboard = SquareBitboard(from);
+		const Bitboard toBitboard = SquareBitboard(to);
+
+		// *** Capture *** \\
+
+		if (move.IsEnpassant())
+		{
+			Bitboard capturedBitboard = SquareBitboard(Sq0x88To64(move.GetOtherSquareToClear()));
+			g_position.Pieces[Piece::PieceIndexPawn] ^= capturedBitboard;
+			g_position.Colours[them] ^= capturedBitboard;
+		}
+		else if (capturedPieceIndex != Piece::PieceIndexNone)
+		{
+			g_position.Pieces[capturedPieceIndex] ^= toBitboard;
+			g_position.Colours[them] ^= toBitboard;
+		}
+
+		// *** Move *** \\
+
+		g_position.Pieces[movedPieceIndex] ^= fromBitboard | toBitboard;
+		g_position.Colours[us] ^= fromBitboard | toBitboard;
+
+		if (move.IsPromotion())
+		{
+			g_position.Pieces[Piece::PieceIndexPawn] ^= toBitboard;
+			g_position.Pieces[Piece::PieceTypeToIndex(move.GetPromoteTo())] ^= toBitboard;
+		}
+
+		if (move.IsCastling())
+		{
+			Bitboard rookBitboard = SquareBitboard(Sq0x88To64(move.GetSecondaryMoveFrom())) | SquareBitboard(Sq0x88To64(move.GetSecondaryMoveTo()));
+			g_position.Pieces[Piece::PieceIndexRook] ^= rookBitboard;
+			g_position.Colours[us] ^= rookBitboard;
+		}
+
+		// *** State *** \\
+
+		g_position.CastlingRights &= CastlingRightsMask[from] & CastlingRightsMask[to];
+
+		g_position.EnpassantTargetSquare = NullSquare64;
+		if (movedPieceIndex == Piece::PieceIndexPawn)
+		{
+			g_position.HalfMoveClock = 0;
+			if (move.GetFlags() == Move::MoveFlagDoublePawnPush)
+			{
+				g_position.EnpassantTargetSquare = (from + to) / 2;
+			}
+		}
+		else if (capturedPieceIndex != Piece::PieceIndexNone)
+		{
+			g_position.HalfMoveClock = 0;
+		}
+		else
+		{
+			++g_position.HalfMoveClock;
+		}
+
+		if (us == Piece::ColourIndexBlack) ++g_position.FullMoveNumber;
+		g_position.ColourToMove = them;
+
+		return true;
+	}
+
+	void BoardBitboard::UnMakeMove()
+	{
+		if (g_useCopyMake)
+		{
+			--g_positionHistoryLength;
+			g_position = g_positionHistory[g_positionHistoryLength];
+			return;
+		}
+
+		--g_UnmakeLength;
+
+		const UnmakeItemBitboard& unmakeItem = g_UnmakeList[g_UnmakeLength];
+		const Move& move = unmakeItem.MoveMade;
+
+		// *** State *** \\
+
+		g_position.ColourToMove ^= 1;
+		g_position.CastlingRights = unmakeItem.CastlingRights;
+		g_position.EnpassantTargetSquare = unmakeItem.EnpassantTargetSquare;
+		g_position.HalfMoveClock = unmakeItem.HalfMoveClock;
+		g_position.FullMoveNumber = unmakeItem.FullMoveNumber;
+
+		const int us = g_position.ColourToMove;
+		const int them = us ^ 1;
+
+		const Bitboard fromBitboard = SquareBitboard(Sq0x88To64(move.GetMoveFrom()));
+		const Bitboard toBitboard = SquareBitboard(Sq0x88To64(move.GetMoveTo()));
+
+		// *** Move *** \\
+
+		if (move.IsPromotion())
+		{
+			g_position.Pieces[Piece::PieceTypeToIndex(move.GetPromoteTo())] ^= toBitboard;
+			g_position.Pieces[Piece::PieceIndexPawn] ^= toBitboard;
+		}
+
+		g_position.Pieces[unmakeItem.MovedPieceIndex] ^= fromBitboard | toBitboard;
+		g_position.Colours[us] ^= fromBitboard | toBitboard;
+
+		if (move.IsCastling())
+		{
+			Bitboard rookBitboard = SquareBitboard(Sq0x88To64(move.GetSecondaryMoveFrom())) | SquareBitboard(Sq0x88To64(move.GetSecondaryMoveTo()));
+			g_position.Pieces[Piece::PieceIndexRook] ^= rookBitboard;
+			g_position.Colours[us] ^= rookBitboard;
+		}
+
+		// *** Capture *** \\
+
+		if (unmakeItem.CapturedPieceIndex != Piece::PieceIndexNone)
+		{
+			Bitboard capturedBitboard = toBitboard;
+			if (move.IsEnpassant())
+			{
+				capturedBitboard = SquareBitboard(Sq0x88To64(move.GetOtherSquareToClear()));
+			}
+			g_position.Pieces[unmakeItem.CapturedPieceIndex] ^= capturedBitboard;
+			g_position.Colours[them] ^= capturedBitboard;
+		}
+	}
+
+	std::string BoardBitboard::GetPositionAsFen()
+	{
+		static constexpr char whitePieces[Piece::PieceTypeCount] = { 'K', 'R', 'N', 'B', 'Q', 'P' };
+		static constexpr char blackPieces[Piece::PieceTypeCount] = { 'k', 'r', 'n', 'b', 'q', 'p' };
+
+		std::stringstream result;
+
+		for (int rank = 7; rank >= 0; --rank)
+		{
+			if (rank < 7) result << "/";
+			int noPieceCount{ 0 };
+			for (int file = 0; file <= 7; ++file)
+			{
+				BoardIndex64 sq64 = rank * 8 + file;
+				int pieceIndex = GetPieceIndexOnSquare(sq64);
+
+				if (pieceIndex == Piece::PieceIndexNone)
+				{
+					++noPieceCount;
+				}
+				else
+				{
+					if (noPieceCount > 0) result << noPieceCount;
+					noPieceCount = 0;
+
+					if ((g_position.Colours[Piece::ColourIndexWhite] & SquareBitboard(sq64)) != 0)
+					{
+						result << whitePieces[pieceIndex];
+					}
+					else
+					{
+						result << blackPieces[pieceIndex];
+					}
+				}
+			}
+			if (noPieceCount > 0) result << noPieceCount;
+		}
+
+		result << (g_position.ColourToMove == Piece::ColourIndexWhite ? " w " : " b ");
+
+		if (g_position.CastlingRights == 0)
+		{
+			result << "- ";
+		}
+		else
+		{
+			if ((g_position.CastlingRights & CastleWhiteKingSide) != 0) result << "K";
+			if ((g_position.CastlingRights & CastleWhiteQueenSide) != 0) result << "Q";
+			if ((g_position.CastlingRights & CastleBlackKingSide) != 0) result << "k";
+			if ((g_position.CastlingRights & CastleBlackQueenSide) != 0) result << "q";
+			result << " ";
+		}
+
+		if (g_position.EnpassantTargetSquare == NullSquare64)
+		{
+			result << "- ";
+		}
+		else
+		{
+			result << Sq0x88ToTextSquare(Sq64To0x88(g_position.EnpassantTargetSquare)) << " ";
+		}
+
+		result << g_position.HalfMoveClock << " ";
+
+		result << g_position.FullMoveNumber;
+
+		return result.str();
+	}
+
+	bool BoardBitboard::SetPositionFromFen(std::string fen)
+	{
+		//Parse and validate using the 0x88 board then copy the position across
+		Board board;
+		if (!board.SetPositionFromFen(fen))
+		{
+			NewGame();
+			return false;
+		}
+
+		ClearBoard();
+
+		for (BoardIndex64 sq64 = 0; sq64 < 64; ++sq64)
+		{
+			BoardIndex0x88 sq0x88 = Sq64To0x88(sq64);
+			int pieceType = board.GetSquarePieceType(sq0x88);
+			if (pieceType != Piece::PieceTypeNone)
+			{
+				SetPieceOnSquare(
+					sq64,
+					Piece::PieceTypeToIndex(pieceType),
+					Piece::ColourToIndex(board.GetSquarePieceColour(sq0x88)));
+			}
+		}
+
+		g_position.ColourToMove = Piece::ColourToIndex(board.GetColourToMove());
+
+		g_position.CastlingRights = 0;
+		if (board.GetCanWhiteCastleKingSide()) g_position.CastlingRights |= CastleWhiteKingSide;
+		if (board.GetCanWhiteCastleQueenSide()) g_position.CastlingRights |= CastleWhiteQueenSide;
+		if (board.GetCanBlackCastleKingSide()) g_position.CastlingRights |= CastleBlackKingSide;
+		if (board.GetCanBlackCastleQueenSide()) g_position.CastlingRights |= CastleBlackQueenSide;
+
+		g_position.EnpassantTargetSquare = NullSquare64;
+		if (board.GetEnpassantTargetSquare() != Null0x88Square)
+		{
+			g_position.EnpassantTargetSquare = Sq0x88To64(board.GetEnpassantTargetSquare());
+		}
+
+		g_position.HalfMoveClock = board.GetHalfMoveClock();
+		g_position.FullMoveNumber = board.GetFullMoveNumber();
+		g_UnmakeLength = 0;
+		g_positionHistoryLength = 0;
+
+		return true;
+	}
+
+	void BoardBitboard::ClearBoard()
+	{
+		for (int i = 0; i < Piece::PieceTypeCount; ++i)
+		{
+			g_position.Pieces[i] = 0;
+		}
+		g_position.Colours[Piece::ColourIndexWhite] = 0;
+		g_position.Colours[Piece::ColourIndexBlack] = 0;
+	}
+
+	void BoardBitboard::SetPieceOnSquare(BoardIndex64 sq64, int pieceIndex, int colourIndex)
+	{
+		g_position.Pieces[pieceIndex] |= SquareBitboard(sq64);
+		g_position.Colours[colourIndex] |= SquareBitboard(sq64);
+	}
+
+	int BoardBitboard::GetPieceIndexOnSquare(BoardIndex64 sq64) const
+	{
+		Bitboard b = SquareBitboard(sq64);
+		if ((g_position.Pieces[Piece::PieceIndexPawn] & b) != 0) return Piece::PieceIndexPawn;
+		if ((g_position.Pieces[Piece::PieceIndexKnight] & b) != 0) return Piece::PieceIndexKnight;
+		if ((g_position.Pieces[Piece::PieceIndexBishop] & b) != 0) return Piece::PieceIndexBishop;
+		if ((g_position.Pieces[Piece::PieceIndexRook] & b) != 0) return Piece::PieceIndexRook;
+		if ((g_position.Pieces[Piece::PieceIndexQueen] & b) != 0) return Piece::PieceIndexQueen;
+		if ((g_position.Pieces[Piece::PieceIndexKing] & b) != 0) return Piece::PieceIndexKing;
+		return Piece::PieceIndexNone;
+	}
+
+	void BoardBitboard::AddMove(
+		const BoardIndex64 start,
+		const BoardIndex64 target,
+		const unsigned int flags,
+		Move* moves,
+		int& moveCount)
+	{
+		moves[moveCount] = Move(Sq64To0x88(start), Sq64To0x88(target), flags);
+
+		++moveCount;
+	}
+
+	void BoardBitboard::AddMovesToTargets(BoardIndex64 start, Bitboard targets, Move* moves, int& moveCount)
+	{
+		const Bitboard enemy = g_position.Colours[g_position.ColourToMove ^ 1];
+
+		while (targets != 0)
+		{
+			BoardIndex64 target = PopLeastSignificantSquare(targets);
+			AddMove(start, target, (enemy & SquareBitboard(target)) != 0 ? Move::MoveFlagCapture : Move::MoveFlagQuiet, moves, moveCount);
+		}
+	}
+
+	void BoardBitboard::AddPawnMovesToTargets(Bitboard targets, int offset, unsigned int flags, Move* moves, int& moveCount)
+	{
+		//Promotions keep the capture flag
+		const unsigned int captureFlag = flags & Move::MoveFlagCapture;
+
+		while (targets != 0)
+		{
+			BoardIndex64 target = PopLeastSignificantSquare(targets);
+			BoardIndex64 start = target - offset;
+
+			if ((SquareBitboard(target) & (Rank1Bitboard | Rank8Bitboard)) != 0)
+			{
+				//Promotion
+				AddMove(start, target, Move::MoveFlagPromoteQueen | captureFlag, moves, moveCount);
+				AddMove(start, target, Move::MoveFlagPromoteRook | captureFlag, moves, moveCount);
+				AddMove(start, target, Move::MoveFlagPromoteBishop | captureFlag, moves, moveCount);
+				AddMove(start, target, Move::MoveFlagPromoteKnight | captureFlag, moves, moveCount);
+			}
+			else
+			{
+				AddMove(start, target, flags, moves, moveCount);
+			}
+		}
+	}
+
+	void BoardBitboard::AddPawnMoves(Bitboard pawns, Bitboard targetMask, Move* moves, int& moveCount)
+	{
+		const Bitboard enemy = g_position.Colours[g_position.ColourToMove ^ 1];
+		const Bitboard empty = ~(g_position.Colours[g_position.ColourToMove] | enemy);
+
+		if (g_position.ColourToMove == Piece::ColourIndexWhite)
+		{
+			//White
+			Bitboard single = (pawns << 8) & empty;
+			AddPawnMovesToTargets(single & targetMask, 8, Move::MoveFlagQuiet, moves, moveCount);
+			AddPawnMovesToTargets(((single & Rank3Bitboard) << 8) & empty & targetMask, 16, Move::MoveFlagDoublePawnPush, moves, moveCount);
+			AddPawnMovesToTargets(((pawns & ~FileABitboard) << 7) & enemy & targetMask, 7, Move::MoveFlagCapture, moves, moveCount);
+			AddPawnMovesToTargets(((pawns & ~FileHBitboard) << 9) & enemy & targetMask, 9, Move::MoveFlagCapture, moves, moveCount);
+		}
+		else
+		{
+			//Black
+			Bitboard single = (pawns >> 8) & empty;
+			AddPawnMovesToTargets(single & targetMask, -8, Move::MoveFlagQuiet, moves, moveCount);
+			AddPawnMovesToTargets(((single & Rank6Bitboard) >> 8) & empty & targetMask, -16, Move::MoveFlagDoublePawnPush, moves, moveCount);
+			AddPawnMovesToTargets(((pawns & ~FileABitboard) >> 9) & enemy & targetMask, -9, Move::MoveFlagCapture, moves, moveCount);
+			AddPawnMovesToTargets(((pawns & ~FileHBitboard) >> 7) & enemy & targetMask, -7, Move::MoveFlagCapture, moves, moveCount);
+		}
+	}
+
+	void BoardBitboard::AddEnpassantMoves(Move* moves, int& moveCount)
+	{
+		if (g_position.EnpassantTargetSquare != NullSquare64)
+		{
+			const Bitboard pawns = g_position.Pieces[Piece::PieceIndexPawn] & g_position.Colours[g_position.ColourToMove];
+
+			//Pawns that could capture onto the target square are those a pawn of the other colour would attack from it
+			Bitboard attackers = BitboardAttacks::GetPawnAttacks(g_position.ColourToMove ^ 1, g_position.EnpassantTargetSquare) & pawns;
+			while (attackers != 0)
+			{
+				BoardIndex64 start = PopLeastSignificantSquare(attackers);
+				AddMove(start, g_position.EnpassantTargetSquare, Move::MoveFlagEnpassant, moves, moveCount);
+			}
+		}
+	}
+
+	void BoardBitboard::AddCastlingMoves(Move* moves, int& moveCount)
+	{
+		const Bitboard occupancy = g_position.Colours[Piece::ColourIndexWhite] | g_position.Colours[Piece::ColourIndexBlack];
+
+		//King and Rook must be in position for castling, the castling rights ensure this.
+		//Check tests are only tested on MakeMove()
+		if (g_position.ColourToMove == Piece::ColourIndexWhite)
+		{
+			if ((g_position.CastlingRights & CastleWhiteKingSide) != 0 && (occupancy & 0x60ULL) == 0)
+			{
+				AddMove(4, 6, Move::MoveFlagKingSideCastle, moves, moveCount);
+			}
+			if ((g_position.CastlingRights & CastleWhiteQueenSide) != 0 && (occupancy & 0x0EULL) == 0)
+			{
+				AddMove(4, 2, Move::MoveFlagQueenSideCastle, moves, moveCount);
+			}
+		}
+		else
+		{
+			if ((g_position.CastlingRights & CastleBlackKingSide) != 0 && (occupancy & (0x60ULL << 56)) == 0)
+			{
+				AddMove(60, 62, Move::MoveFlagKingSideCastle, moves, moveCount);
+			}
+			if ((g_position.CastlingRights & CastleBlackQueenSide) != 0 && (occupancy & (0x0EULL << 56)) == 0)
+			{
+				AddMove(60, 58, Move::MoveFlagQueenSideCastle, moves, moveCount);
+			}
+		}
+	}
+
+	Bitboard BoardBitboard::GetAttackers(BoardIndex64 sq64, Bitboard occupancy, int attackingColourIndex) const
+	{
+		const Bitboard queens = g_position.Pieces[Piece::PieceIndexQueen];
+
+		return g_position.Colours[attackingColourIndex] & (
+			(BitboardAttacks::GetKnightAttacks(sq64) & g_position.Pieces[Piece::PieceIndexKnight]) |
+			//A pawn attacks the square if a pawn of the other colour on the square would attack it
+			(BitboardAttacks::GetPawnAttacks(attackingColourIndex ^ 1, sq64) & g_position.Pieces[Piece::PieceIndexPawn]) |
+			(BitboardAttacks::GetKingAttacks(sq64) & g_position.Pieces[Piece::PieceIndexKing]) |
+			(BitboardAttacks::GetBishopAttacks(sq64, occupancy) & (g_position.Pieces[Piece::PieceIndexBishop] | queens)) |
+			(BitboardAttacks::GetRookAttacks(sq64, occupancy) & (g_position.Pieces[Piece::PieceIndexRook] | queens)));
+	}
+
+	bool BoardBitboard::IsSquareAttacked(BoardIndex64 sq64, int attackingColourIndex) const
+	{
+		const Bitboard attackers = g_position.Colours[attackingColourIndex];
+		const Bitboard occupancy = g_position.Colours[Piece::ColourIndexWhite] | g_position.Colours[Piece::ColourIndexBlack];
+
+		if ((BitboardAttacks::GetKnightAttacks(sq64) & g_position.Pieces[Piece::PieceIndexKnight] & attackers) != 0) return true;
+		//A pawn attacks the square if a pawn of the other colour on the square would attack it
+		if ((BitboardAttacks::GetPawnAttacks(attackingColourIndex ^ 1, sq64) & g_position.Pieces[Piece::PieceIndexPawn] & attackers) != 0) return true;
+		if ((BitboardAttacks::GetKingAttacks(sq64) & g_position.Pieces[Piece::PieceIndexKing] & attackers) != 0) return true;
+
+		const Bitboard queens = g_position.Pieces[Piece::PieceIndexQueen];
+		if ((BitboardAttacks::GetBishopAttacks(sq64, occupancy) & (g_position.Pieces[Piece::PieceIndexBishop] | queens) & attackers) != 0) return true;
+		if ((BitboardAttacks::GetRookAttacks(sq64, occupancy) & (g_position.Pieces[Piece::PieceIndexRook] | queens) & attackers) != 0) return true;
+
+		return false;
+	}
+}
@@ -0,0 +1,306 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains a bitboard based alternative to the 0x88 Board. It has the
+	same move generation, make and unmake surface as Board so it can be used
+	anywhere Board is (e.g. perft).
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATHENAZERO_ENGINE_BOARDBITBOARD
+#define ATHENAZERO_ENGINE_BOARDBITBOARD
+
+#include <string>
+
+#include "piece.h"
+#include "move.h"
+#include "typedefs.h"
+#include "bitboardlib.h"
+#include "bitboardattacks.h"
+#include "constants.h"
+#include "bitboardposition.h"
+
+namespace ATHENAZEROENG
+{
+	/*
+		Holds the state so a move made on a BoardBitboard can be undone.
+	*/
+	class UnmakeItemBitboard
+	{
+	public:
+		//The move made
+		Move MoveMade;
+		//The piece index (Piece::PieceIndexXXX) of the moving piece before the move (Pawn if promoting)
+		int MovedPieceIndex{ Piece::PieceIndexNone };
+		//The piece index (Piece::PieceIndexXXX) of the captured piece or Piece::PieceIndexNone
+		int CapturedPieceIndex{ Piece::PieceIndexNone };
+
+		//State before the move is made
+		unsigned int CastlingRights{ 0 };
+		BoardIndex64 EnpassantTargetSquare{ NullSquare64 };
+		int HalfMoveClock{ 0 };
+		int FullMoveNumber{ 1 };
+	};
+
+	class BoardBitboard
+	{
+	public:
+		/*
+			Creates a new instance of the class and initialises a new game starting at the standard chess
+			starting position.
+		*/
+		BoardBitboard();
+
+		/*
+			Resets to the start of a new game starting at the standard chess
+			starting position.
+		*/
+		void NewGame();
+
+		/*
+			Generates pseudo legal moves. These are moves that are valid, but may leave the player
+			in check or castling may not be possible due to check. Calling MakeMove() with one of
+			these moves will do these tests.
+
+			moves: An array. Should be at least 238 in length to avoid
+				   potential overflows.
+			moveCount: Initially set to 0 by this method. When the method returns
+					   this will contain the count of moves added to the moves
+					   array.
+		*/
+		void GeneratePseudoLegalMoves(Move* moves, int& moveCount);
+
+		/*
+			Generates legal moves only, using the checking pieces and the pinned pieces
+			so moves that would leave the king in check are never generated. Use
+			MakeLegalMove() to make the moves.
+
+			moves: An array. Should be at least 238 in length to avoid
+				   potential overflows.
+			moveCount: Initially set to 0 by this method. When the method returns
+					   this will contain the count of moves added to the moves
+					   array.
+		*/
+		void GenerateLegalMoves(Move* moves, int& moveCount);
+
+		/*
+			Makes the specified move. Only pass a move returned by GeneratePseudoLegalMoves()
+			to avoid undefined behaviour.
+
+			move: The move.
+
+			Returns: True if the move is ok, false if it is not valid (i.e.
+					 leave the king in check or castling not possible).
+		*/
+		bool MakeMove(const Move& move);
+
+		/*
+			Makes the specified move without testing if it leaves the king in check. Only pass
+			a move returned by GenerateLegalMoves() to avoid undefined behaviour.
+
+			move: The move.
+
+			Returns: True if the move was made, false if the unmake list is full.
+		*/
+		bool MakeLegalMove(const Move& move);
+
+		/*
+			Unmakes a move. Does no validation so do NOT call when there are
+			no moves to unmake, will cause an overflow and thus undefined
+			behaviour.
+		*/
+		void UnMakeMove();
+
+		/*
+			Gets the FEN (Forsyth-Edwards Notation) for the current position.
+
+			Returns: The FEN position.
+		*/
+		std::string GetPositionAsFen();
+
+		/*
+			Sets the positon from the FEN (Forsyth-Edwards Notation) for a position. Uses
+			the same parsing and validation as Board::SetPositionFromFen().
+
+			fen: The FEN positon to set.
+
+			Returns: True if valid, false otherwise. If false is returned then the game will be set to the start
+					 of a new game using the standard chess starting position.
+		*/
+		bool SetPositionFromFen(std::string fen);
+
+		/*
+			Gets the current colour to move.
+			Piece::PieceColourWhite or Piece::PieceColourBlack.
+		*/
+		inline int GetColourToMove() const
+		{
+			return Piece::IndexToColour(g_position.ColourToMove);
+		}
+
+		/*
+			Gets the half move clock. Resets to 0 after a pawn move or capture.
+		*/
+		inline int GetHalfMoveClock() const
+		{
+			return g_position.HalfMoveClock;
+		}
+
+		/*
+			Gets the full move number. Starts at 1 and increments after black's move.
+		*/
+		inline int GetFullMoveNumber() const
+		{
+			return g_position.FullMoveNumber;
+		}
+
+		/*
+			Sets whether moves are undone by copy-make or by the unmake list. With copy-make
+			the whole position (a BitboardPosition) is copied before each move and UnMakeMove()
+			copies it back. Otherwise only what is needed to reverse the move is recorded and
+			UnMakeMove() reverses it. Only change when no moves have been made.
+		*/
+		inline void SetUseCopyMake(const bool useCopyMake)
+		{
+			g_useCopyMake = useCopyMake;
+		}
+
+		/*
+			Gets the position. A plain copyable value, e.g. to hand to another thread.
+		*/
+		inline const BitboardPosition& GetPosition() const
+		{
+			return g_position;
+		}
+
+	private:
+		static constexpr unsigned int CastleWhiteKingSide = 1;
+		static constexpr unsigned int CastleWhiteQueenSide = 2;
+		static constexpr unsigned int CastleBlackKingSide = 4;
+		static constexpr unsigned int CastleBlackQueenSide = 8;
+		static constexpr unsigned int CastleAll = 15;
+
+		/*
+			Castling rights are ANDed with the entries for the move from and to squares, so
+			moving a king or rook (or capturing a rook) removes the relevant rights.
+		*/
+		static const unsigned int CastlingRightsMask[64];
+
+		//The position. Everything a move changes is held here.
+		BitboardPosition g_position;
+
+		UnmakeItemBitboard g_UnmakeList[FixedUnmakeMoveListCapacity];
+		size_t g_UnmakeLength{ 0 };
+
+		//Copy-make: the position before each move made, used instead of g_UnmakeList
+		BitboardPosition g_positionHistory[FixedUnmakeMoveListCapacity];
+		size_t g_positionHistoryLength{ 0 };
+
+		//True to use copy-make (g_positionHistory) rather than the unmake list
+		bool g_useCopyMake{ false };
+
+		/*
+			Ensures the entire board is clear (i.e. contains no pieces).
+		*/
+		void ClearBoard();
+
+		/*
+			Adds a piece to an empty square.
+
+			sq64: The square.
+			pieceIndex: The piece index (Piece::PieceIndexXXX).
+			colourIndex: The colour index (Piece::ColourIndexXXX).
+		*/
+		void SetPieceOnSquare(BoardIndex64 sq64, int pieceIndex, int colourIndex);
+
+		/*
+			Gets the piece index (Piece::PieceIndexXXX) on a square, Piece::PieceIndexNone if empty.
+		*/
+		int GetPieceIndexOnSquare(BoardIndex64 sq64) const;
+
+		/*
+			Adds a move to the move list. Squares are bitboard squares (0-63) and are converted
+			to the 0x88 squares used by Move.
+
+			start: The starting square.
+			target: The destination square.
+			flags: The Move::MoveFlagXXX value describing the move.
+			moves: The move list.
+			moveCount: Added to by this method.
+		*/
+		void AddMove(
+			const BoardIndex64 start,
+			const BoardIndex64 target,
+			const unsigned int flags,
+			Move* moves,
+			int& moveCount);
+
+		/*
+			Adds a normal (non-pawn) move from start to every square in targets. Moves
+			onto an enemy piece are flagged as captures.
+		*/
+		void AddMovesToTargets(BoardIndex64 start, Bitboard targets, Move* moves, int& moveCount);
+
+		/*
+			Adds pawn moves for each square in targets. Adds all four promotions when
+			the target is on the first or last rank.
+
+			targets: The destination squares.
+			offset: The value to subtract from a target square to get the starting square.
+			flags: Move::MoveFlagQuiet, Move::MoveFlagDoublePawnPush or Move::MoveFlagCapture.
+		*/
+		void AddPawnMovesToTargets(Bitboard targets, int offset, unsigned int flags, Move* moves, int& moveCount);
+
+		/*
+			Adds pawn moves (excluding enpassant) for the side to move.
+
+			pawns: The pawns to add moves for.
+			targetMask: Only moves to these squares are added.
+		*/
+		void AddPawnMoves(Bitboard pawns, Bitboard targetMask, Move* moves, int& moveCount);
+
+		/*
+			Adds enpassant captures for the side to move.
+		*/
+		void AddEnpassantMoves(Move* moves, int& moveCount);
+
+		/*
+			Adds castling moves for the side to move. Only the squares between king and rook
+			are tested, check tests are done by MakeMove().
+		*/
+		void AddCastlingMoves(Move* moves, int& moveCount);
+
+		/*
+			Determines if a square is attacked.
+
+			sq64: The attacked square.
+			attackingColourIndex: The side attacking (Piece::ColourIndexXXX).
+			Returns: True if the square is attacked, false otherwise.
+		*/
+		bool IsSquareAttacked(BoardIndex64 sq64, int attackingColourIndex) const;
+
+		/*
+			Gets the pieces of one colour attacking a square.
+
+			sq64: The attacked square.
+			occupancy: The occupied squares used for slider attacks (e.g. without a moving king).
+			attackingColourIndex: The side attacking (Piece::ColourIndexXXX).
+			Returns: The attacking pieces.
+		*/
+		Bitboard GetAttackers(BoardIndex64 sq64, Bitboard occupancy, int attackingColourIndex) const;
+	};
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains the small, frequently accessed state of a Board (side to
+	move, castling rights, king squares, enpassant square and move counters).
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATHENAZERO_ENGINE_BOARDSTATE
+#define ATHENAZERO_ENGINE_BOARDSTATE
+
+#include "board0x88lib.h"
+#include "typedefs.h"
+#include "piece.h"
+
+namespace ATHENAZEROENG
+{
+	/*
+		Everything about a position other than the piece placement. Kept to a few bytes
+		(16 byte aligned so it never straddles a cache line) so it can be saved and
+		restored for unmake with a single copy.
+	*/
+	class alignas(16) BoardState
+	{
+	public:
+		static constexpr unsigned char CastleWhiteKingSide = 1;
+		static constexpr unsigned char CastleWhiteQueenSide = 2;
+		static constexpr unsigned char CastleBlackKingSide = 4;
+		static constexpr unsigned char CastleBlackQueenSide = 8;
+		static constexpr unsigned char CastleAll = 15;
+
+		/*
+			The current side (colour) to move.
+			* Piece::PieceColourWhite
+			* Piece::PieceColourBlack
+		*/
+		unsigned char ColourToMove{ Piece::PieceColourWhite };
+
+		//Combination of the CastleXXX values
+		unsigned char CastlingRights{ CastleAll };
+
+		CompactBoardIndex0x88 WhiteKingLocation0x88{ Null0x88Square };
+		CompactBoardIndex0x88 BlackKingLocation0x88{ Null0x88Square };
+
+		CompactBoardIndex0x88 EnpassantTargetSquare{ Null0x88Square };
+
+		//Starts at zero. Inceremented after every ply, reset to 0 after a pawn move or capture.
+		unsigned short HalfMoveClock{ 0 };
+
+		//Starts at 1 and increments after black's move.
+		unsigned short FullMoveNumber{ 1 };
+	};
+}
+
+#endif
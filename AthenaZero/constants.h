@@ -23,18 +23,20 @@
 namespace ATHENAZEROENG
 {
 	/*
-		Holds the initial size of the unmake move list which is a basic
-		array.
-
-		Ideally set high so that it will always be big enough, increasing the
-		size later is expensive.
+		Capacity of unmake move lists that are a fixed size (i.e. never grow), so the
+		most moves (game moves plus the search path, including null moves) that can be
+		made at once. A legal game can be longer than this, making a move returns false
+		once the list is full.
+	*/
+	constexpr int FixedUnmakeMoveListCapacity = 1024;
+	/*
+		Capacity of a move list holding the moves generated for one position.
 	*/
-	constexpr int InitialUnmakeMoveListCapacity = 255;
+	constexpr int MaxMovesInPosition = 255;
 	/*
-		If the unmake move list becomes full (probably unlikely)
-		then it is increased in size by this amount.
+		Size in bytes of a CPU cache line, used to align hot arrays.
 	*/
-	constexpr int UnmakeMoveListCapacityIncrement = 10;
+	constexpr int CacheLineSize = 64;
 }
 
 #endif
@@ -0,0 +1,198 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains code to load positions in bulk from a FEN or EPD file, one
+	position per line. The file is memory mapped and each line is parsed in place
+	so loading does not allocate per position.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+#include "fenfile.h"
+
+namespace ATHENAZEROENG
+{
+	FenFile::~FenFile()
+	{
+		Close();
+	}
+
+#ifdef _WIN32
+	bool FenFile::Open(const std::string& path)
+	{
+		Close();
+
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		g_fileHandle = file;
+		g_size = static_cast<size_t>(size.QuadPart);
+
+		//An empty file cannot be mapped, it simply has no lines
+		if (g_size == 0) return true;
+
+		g_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (g_mappingHandle == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		g_data = static_cast<const char*>(MapViewOfFile(g_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		if (g_data == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void FenFile::Close()
+	{
+		if (g_data != nullptr) UnmapViewOfFile(g_data);
+		if (g_mappingHandle != nullptr) CloseHandle(g_mappingHandle);
+		if (g_fileHandle != nullptr) CloseHandle(g_fileHandle);
+
+		g_data = nullptr;
+		g_mappingHandle = nullptr;
+		g_fileHandle = nullptr;
+		g_size = 0;
+		g_position = 0;
+	}
+#else
+	bool FenFile::Open(const std::string& path)
+	{
+		Close();
+
+		const int file = open(path.c_str(), O_RDONLY);
+		if (file == -1) return false;
+
+		struct stat status;
+		if (fstat(file, &status) != 0)
+		{
+			close(file);
+			return false;
+		}
+
+		//An empty file cannot be mapped, it simply has no lines
+		if (status.st_size == 0)
+		{
+			close(file);
+			return true;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+		//The mapping keeps the file open
+		close(file);
+
+		if (data == MAP_FAILED) return false;
+
+		madvise(data, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+
+		g_data = static_cast<const char*>(data);
+		g_size = static_cast<size_t>(status.st_size);
+
+		return true;
+	}
+
+	void FenFile::Close()
+	{
+		if (g_data != nullptr) munmap(const_cast<char*>(g_data), g_size);
+
+		g_data = nullptr;
+		g_size = 0;
+		g_position = 0;
+	}
+#endif
+
+	size_t FenFile::LoadPackedPositions(Board& board, const int format, const bool validate, std::vector<PackedPosition>& positions, size_t& invalidCount)
+	{
+		//Roughly 50 bytes a line, so the vector is not regrown many times
+		positions.reserve(positions.size() + (g_size - g_position) / 50);
+
+		size_t packedCount = 0;
+		size_t unpackableCount = 0;
+		LoadPositions(
+			board,
+			format,
+			validate,
+			[&](Board& loaded)
+			{
+				PackedPosition packed;
+				if (loaded.GetPackedPosition(packed))
+				{
+					positions.push_back(packed);
+					++packedCount;
+				}
+				else
+				{
+					++unpackableCount;
+				}
+			},
+			invalidCount);
+
+		invalidCount += unpackableCount;
+
+		return packedCount;
+	}
+
+	bool FenFile::NextLine(const char*& line, size_t& length)
+	{
+		while (g_position < g_size)
+		{
+			const char* start = g_data + g_position;
+			const char* end = g_data + g_size;
+
+			const char* lineEnd = static_cast<const char*>(std::memchr(start, '\n', static_cast<size_t>(end - start)));
+			if (lineEnd == nullptr) lineEnd = end;
+
+			g_position = static_cast<size_t>(lineEnd - g_data);
+			if (lineEnd != end) ++g_position;
+
+			//Drop the \r of a \r\n line ending
+			if (lineEnd != start && *(lineEnd - 1) == '\r') --lineEnd;
+
+			if (lineEnd != start)
+			{
+				line = start;
+				length = static_cast<size_t>(lineEnd - start);
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
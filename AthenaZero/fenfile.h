@@ -0,0 +1,166 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains code to load positions in bulk from a FEN or EPD file, one
+	position per line. The file is memory mapped and each line is parsed in place
+	so loading does not allocate per position.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATHENAZERO_ENGINE_FENFILE
+#define ATHENAZERO_ENGINE_FENFILE
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "board.h"
+#include "packedposition.h"
+
+namespace ATHENAZEROENG
+{
+	class FenFile
+	{
+	public:
+		//Each line is FEN (the move counters are optional)
+		static constexpr int FormatFen = 0;
+		//Each line is EPD, the operations after the first four fields are ignored
+		static constexpr int FormatEpd = 1;
+
+		/*
+			Creates a new instance of the class. Call Open() to map a file.
+		*/
+		FenFile() = default;
+
+		/*
+			Unmaps the file.
+		*/
+		~FenFile();
+
+		//Owns the mapping so cannot be copied
+		FenFile(const FenFile&) = delete;
+		FenFile& operator=(const FenFile&) = delete;
+
+		/*
+			Memory maps a file, closing any file already open.
+
+			path: The file.
+			Returns: True on success, false if the file could not be opened or mapped.
+		*/
+		bool Open(const std::string& path);
+
+		/*
+			Unmaps the file. Any line returned by NextLine() is no longer valid.
+		*/
+		void Close();
+
+		/*
+			Gets the next non blank line. The line points into the mapped file so is only
+			valid until Close() and is not null terminated.
+
+			line: Set to the start of the line.
+			length: Set to the length of the line, excluding the line ending.
+			Returns: True if a line was found, false at the end of the file.
+		*/
+		bool NextLine(const char*& line, size_t& length);
+
+		/*
+			Starts reading from the first line again.
+		*/
+		inline void Rewind()
+		{
+			g_position = 0;
+		}
+
+		/*
+			Gets the size of the mapped file in bytes. 0 if no file is open.
+		*/
+		inline size_t GetSize() const
+		{
+			return g_size;
+		}
+
+		/*
+			Sets each position from the current line to the end of the file on a board and
+			calls visitor(board) for each one that is valid. The same board is reused, so
+			copy anything needed before the visitor returns.
+
+			TVisitor: Any callable taking Board&.
+			board: The board to set each position on.
+			format: FormatFen or FormatEpd.
+			validate: Passed to Board::SetPositionFromFen() / SetPositionFromEpd(). False is
+					  faster but only use it for trusted files.
+			visitor: Called for each valid position.
+			invalidCount: Set to the number of lines that were not valid positions.
+			Returns: The number of valid positions.
+		*/
+		template <class TVisitor>
+		size_t LoadPositions(Board& board, const int format, const bool validate, TVisitor visitor, size_t& invalidCount)
+		{
+			size_t validCount = 0;
+			invalidCount = 0;
+
+			const char* line = nullptr;
+			size_t length = 0;
+			while (NextLine(line, length))
+			{
+				const bool isValid = format == FormatEpd ?
+					board.SetPositionFromEpd(line, length, validate) :
+					board.SetPositionFromFen(line, length, validate);
+
+				if (isValid)
+				{
+					visitor(board);
+					++validCount;
+				}
+				else
+				{
+					++invalidCount;
+				}
+			}
+
+			return validCount;
+		}
+
+		/*
+			Packs each position from the current line to the end of the file, e.g. to convert
+			a FEN dataset to the binary format once.
+
+			board: The board used to parse each position.
+			format: FormatFen or FormatEpd.
+			validate: See LoadPositions().
+			positions: Each valid position is added to the end.
+			invalidCount: Set to the number of lines that were not valid positions (or could not be packed).
+			Returns: The number of positions added.
+		*/
+		size_t LoadPackedPositions(Board& board, const int format, const bool validate, std::vector<PackedPosition>& positions, size_t& invalidCount);
+
+	private:
+		//The mapped file, nullptr if no file is open
+		const char* g_data{ nullptr };
+		size_t g_size{ 0 };
+
+		//The offset of the next line
+		size_t g_position{ 0 };
+
+#ifdef _WIN32
+		//The file and mapping handles (HANDLE, kept as void* so windows.h is not needed here)
+		void* g_fileHandle{ nullptr };
+		void* g_mappingHandle{ nullptr };
+#endif
+	};
+}
+
+#endif
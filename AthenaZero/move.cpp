@@ -18,8 +18,6 @@
 	along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <sstream>
-
 #include "movelib.h"
 #include "move.h"
 #include "piece.h"
@@ -27,53 +25,49 @@
 
 namespace ATHENAZEROENG
 {
-	std::string Move::GetMoveAsStandardFormat()
+	std::string Move::GetMoveAsStandardFormat() const
 	{
-		if (!Is0x88SquareValid(MoveFrom)) return "";
-		if (!Is0x88SquareValid(MoveTo)) return "";
-
-		int moveFromFile = From0x88ToFile(MoveFrom);
-		int moveFromRank = From0x88ToRank(MoveFrom);
-
-		int moveToFile = From0x88ToFile(MoveTo);
-		int moveToRank = From0x88ToRank(MoveTo);
+		char buffer[StandardFormatBufferLength];
+		const size_t length = WriteMoveAsStandardFormat(buffer);
 
-		char fromFile = FileToCharacter(moveFromFile);
-		int fromRank = moveFromRank + 1; //Was -1 on error so will now be 0 on error
-
-		char toFile = FileToCharacter(moveToFile);
-		int toRank = moveToRank + 1; //Was -1 on error so will now be 0 on error
+		return std::string(buffer, length);
+	}
 
-		if (fromFile == '-') return "";
-		if (fromRank == 0) return "";
-		if (toFile == '-') return "";
-		if (toRank == 0) return "";
+	size_t Move::WriteMoveAsStandardFormat(char* buffer) const
+	{
+		buffer[0] = '\0';
 
-		std::stringstream s;
+		size_t length = WriteTextSquare(GetMoveFrom(), buffer);
+		if (length == 0) return 0;
 
-		s << fromFile << fromRank << toFile << toRank;
+		const size_t toLength = WriteTextSquare(GetMoveTo(), buffer + length);
+		if (toLength == 0)
+		{
+			buffer[0] = '\0';
+			return 0;
+		}
+		length += toLength;
 
-		if (PromoteTo != Piece::PieceTypeNone)
+		switch (GetPromoteTo())
 		{
-			switch (PromoteTo)
-			{
-			case Piece::PieceTypeQueen:
-				s << "q";
-				break;
-			case Piece::PieceTypeRook:
-				s << "r";
-				break;
-			case Piece::PieceTypeBishop:
-				s << "b";
-				break;
-			case Piece::PieceTypeKnight:
-				s << "n";
-				break;
-			default:
-				return "";
-			}
+		case Piece::PieceTypeNone:
+			break;
+		case Piece::PieceTypeQueen:
+			buffer[length++] = 'q';
+			break;
+		case Piece::PieceTypeRook:
+			buffer[length++] = 'r';
+			break;
+		case Piece::PieceTypeBishop:
+			buffer[length++] = 'b';
+			break;
+		case Piece::PieceTypeKnight:
+			buffer[length++] = 'n';
+			break;
 		}
 
-		return s.str();
+		buffer[length] = '\0';
+
+		return length;
 	}
 }
\ No newline at end of file
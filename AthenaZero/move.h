@@ -26,61 +26,220 @@
 #include "piece.h"
 #include "typedefs.h"
 #include "board0x88lib.h"
+#include "bitboardlib.h"
 
 namespace ATHENAZEROENG
 {
+	/*
+		A move packed into 16 bits:
+			* Bits 0-5: The starting square (0-63)
+			* Bits 6-11: The destination square (0-63)
+			* Bits 12-15: The flags (MoveFlagXXX)
+
+		Everything else (castling rook squares, the enpassant captured pawn and the
+		promotion piece) is derived from the squares and flags. A value of 0 (a1a1) is
+		never a valid move so is used for "no move".
+	*/
 	class Move
 	{
 	public:
+		static constexpr unsigned int MoveFlagQuiet = 0;
+		static constexpr unsigned int MoveFlagDoublePawnPush = 1;
+		static constexpr unsigned int MoveFlagKingSideCastle = 2;
+		static constexpr unsigned int MoveFlagQueenSideCastle = 3;
+		static constexpr unsigned int MoveFlagCapture = 4;
+		static constexpr unsigned int MoveFlagEnpassant = 5;
+
+		/*
+			Set for all promotions. The low two bits hold the piece being promoted to and
+			MoveFlagCapture may also be set.
+		*/
+		static constexpr unsigned int MoveFlagPromotion = 8;
+		static constexpr unsigned int MoveFlagPromoteKnight = 8;
+		static constexpr unsigned int MoveFlagPromoteBishop = 9;
+		static constexpr unsigned int MoveFlagPromoteRook = 10;
+		static constexpr unsigned int MoveFlagPromoteQueen = 11;
+
+		/*
+			Creates a null move (i.e. no move).
+		*/
+		Move() = default;
+
+		/*
+			Creates a move.
+
+			from: The starting square (0x88 format)
+			to: The destination square (0x88 format)
+			flags: The flags, a MoveFlagXXX value (promotions may also include MoveFlagCapture).
+		*/
+		Move(BoardIndex0x88 from, BoardIndex0x88 to, unsigned int flags)
+			: g_data(static_cast<unsigned short>(Sq0x88To64(from) | (Sq0x88To64(to) << 6) | (flags << 12)))
+		{
+		}
+
+		/*
+			Creates a move from a packed 16 bit value returned by GetData().
+		*/
+		explicit Move(unsigned short data) : g_data(data)
+		{
+		}
+
 		/*
 			The starting square (0x88 format)
 		*/
-		BoardIndex0x88 MoveFrom{ Null0x88Square };
+		inline BoardIndex0x88 GetMoveFrom() const
+		{
+			return Sq64To0x88(g_data & 0x3F);
+		}
 
 		/*
 			The destination square (0x88 format)
 		*/
-		BoardIndex0x88 MoveTo{ Null0x88Square };
+		inline BoardIndex0x88 GetMoveTo() const
+		{
+			return Sq64To0x88((g_data >> 6) & 0x3F);
+		}
+
+		/*
+			The flags (MoveFlagXXX).
+		*/
+		inline unsigned int GetFlags() const
+		{
+			return g_data >> 12;
+		}
 
 		/*
-			The promote to. Must be one of:
+			The promote to. One of:
 				* Piece::PieceTypeNone
 				* Piece::PieceTypeRook
 				* Piece::PieceTypeKnight
 				* Piece::PieceTypeBishop
 				* Piece::PieceTypeQueen
 		*/
-		int PromoteTo{ Piece::PieceTypeNone };
+		inline int GetPromoteTo() const
+		{
+			if (!IsPromotion()) return Piece::PieceTypeNone;
+
+			//The piece is held in the low two bits of the flags
+			static constexpr int promotionPieces[4] =
+			{
+				Piece::PieceTypeKnight,
+				Piece::PieceTypeBishop,
+				Piece::PieceTypeRook,
+				Piece::PieceTypeQueen
+			};
+			return promotionPieces[GetFlags() & 3];
+		}
+
+		/*
+			True if the move captures (including enpassant), false otherwise.
+		*/
+		inline bool IsCapture() const
+		{
+			return (GetFlags() & MoveFlagCapture) != 0;
+		}
+
+		/*
+			True if the move is a promotion, false otherwise.
+		*/
+		inline bool IsPromotion() const
+		{
+			return (GetFlags() & MoveFlagPromotion) != 0;
+		}
+
+		/*
+			True if the move is an enpassant capture, false otherwise.
+		*/
+		inline bool IsEnpassant() const
+		{
+			return GetFlags() == MoveFlagEnpassant;
+		}
+
+		/*
+			True if the move is castling (king or queen side), false otherwise.
+		*/
+		inline bool IsCastling() const
+		{
+			return GetFlags() == MoveFlagKingSideCastle || GetFlags() == MoveFlagQueenSideCastle;
+		}
+
+		/*
+			True if this is the null move (i.e. no move), false otherwise.
+		*/
+		inline bool IsNull() const
+		{
+			return g_data == 0;
+		}
 
 		/*
 			If set when the move is made this square is also cleared.
 
-			Used for Enpassant captures, set to the pawn that is actually captured.
+			Used for Enpassant captures, the square of the pawn that is actually captured
+			(same file as the destination, same rank as the start).
 
-			Can always clear even if Null0x88Square as that is a valid array index, just not
-			a valid 0x88 square
+			Null0x88Square for all other moves. This can always be cleared as that is a valid array
+			index, just not a valid 0x88 square.
 		*/
-		BoardIndex0x88 OtherSquareToClear{ Null0x88Square };
+		inline BoardIndex0x88 GetOtherSquareToClear() const
+		{
+			if (!IsEnpassant()) return Null0x88Square;
+			return (GetMoveTo() & 7) | (GetMoveFrom() & 0x70);
+		}
 
 		/*
 			The starting square for the secondary move (0x88 format).
 
-			Used to move te rook when castling.
-
-			If this and SecondaryMoveTo are Null0x88Square then can just copy to self as
-			although an invalid 0x88 square it is a valid array index.
+			Used to move the rook when castling, Null0x88Square for all other moves.
 		*/
-		BoardIndex0x88 SecondaryMoveFrom{ Null0x88Square };
+		inline BoardIndex0x88 GetSecondaryMoveFrom() const
+		{
+			switch (GetFlags())
+			{
+			case MoveFlagKingSideCastle:
+				return GetMoveFrom() + 3;
+			case MoveFlagQueenSideCastle:
+				return GetMoveFrom() - 4;
+			default:
+				return Null0x88Square;
+			}
+		}
 
 		/*
-			The destination square for the secondary move  (0x88 format)
+			The destination square for the secondary move (0x88 format).
 
-			Used to move te rook when castling.
+			Used to move the rook when castling, Null0x88Square for all other moves.
+		*/
+		inline BoardIndex0x88 GetSecondaryMoveTo() const
+		{
+			switch (GetFlags())
+			{
+			case MoveFlagKingSideCastle:
+				return GetMoveFrom() + 1;
+			case MoveFlagQueenSideCastle:
+				return GetMoveFrom() - 1;
+			default:
+				return Null0x88Square;
+			}
+		}
 
-			If this and SecondaryMoveTo are Null0x88Square then can just copy to self as
-			although an invalid 0x88 square it is a valid array index.
+		/*
+			Gets the packed 16 bit value. Suitable for storing in hash tables, training
+			records and so on. Move(unsigned short data) converts back.
 		*/
-		BoardIndex0x88 SecondaryMoveTo{ Null0x88Square };
+		inline unsigned short GetData() const
+		{
+			return g_data;
+		}
+
+		inline bool operator==(const Move& other) const
+		{
+			return g_data == other.g_data;
+		}
+
+		inline bool operator!=(const Move& other) const
+		{
+			return g_data != other.g_data;
+		}
 
 		/*
 			Gets the move in the standard format.
@@ -91,7 +250,23 @@ namespace ATHENAZEROENG
 			Returns: The move in standard format. If there is an invalid value then
 					 returns a blank string.
 		*/
-		std::string GetMoveAsStandardFormat();
+		std::string GetMoveAsStandardFormat() const;
+
+		//The buffer length needed by WriteMoveAsStandardFormat(), e.g. e7e8q plus a null terminator
+		static constexpr size_t StandardFormatBufferLength = 6;
+
+		/*
+			Writes the move in the standard format (see GetMoveAsStandardFormat()) followed by a
+			null terminator. Does not allocate, e.g. for streaming PV lines.
+
+			buffer: At least StandardFormatBufferLength in length.
+			Returns: The number of characters written, excluding the null terminator. 0 if there
+					 is an invalid value.
+		*/
+		size_t WriteMoveAsStandardFormat(char* buffer) const;
+
+	private:
+		unsigned short g_data{ 0 };
 	};
 }
 
@@ -0,0 +1,151 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains code related to picking moves in stages.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "movepicker.h"
+#include "piece.h"
+
+namespace ATHENAZEROENG
+{
+	MovePicker::MovePicker(Board& board, const Move& hashMove)
+		: g_board(board), g_hashMove(hashMove)
+	{
+	}
+
+	bool MovePicker::NextMove(Move& move)
+	{
+		switch (g_stage)
+		{
+		case StageHashMove:
+			g_stage = StageGenerateNoisy;
+			if (g_hashMove != Move())
+			{
+				move = g_hashMove;
+				return true;
+			}
+			//Fall through
+		case StageGenerateNoisy:
+			GenerateNoisyMoves();
+			g_stage = StageWinningNoisy;
+			//Fall through
+		case StageWinningNoisy:
+			while (g_moveIndex < g_winningNoisyCount)
+			{
+				SelectBestMove(g_winningNoisyCount);
+				move = g_moves[g_moveIndex];
+				++g_moveIndex;
+				if (move != g_hashMove) return true;
+			}
+			g_stage = StageRemainingNoisy;
+			//Fall through
+		case StageRemainingNoisy:
+			while (g_moveIndex < g_moveCount)
+			{
+				SelectBestMove(g_moveCount);
+				move = g_moves[g_moveIndex];
+				++g_moveIndex;
+				if (move != g_hashMove) return true;
+			}
+			g_stage = StageGenerateQuiet;
+			//Fall through
+		case StageGenerateQuiet:
+			g_board.GenerateMoves(Board::MoveGenerationQuiet, g_moves, g_moveCount);
+			g_moveIndex = 0;
+			g_stage = StageQuiet;
+			//Fall through
+		case StageQuiet:
+			while (g_moveIndex < g_moveCount)
+			{
+				move = g_moves[g_moveIndex];
+				++g_moveIndex;
+				if (move != g_hashMove) return true;
+			}
+			g_stage = StageDone;
+			//Fall through
+		default:
+			return false;
+		}
+	}
+
+	void MovePicker::GenerateNoisyMoves()
+	{
+		g_board.GenerateCaptures(g_moves, g_moveCount);
+		g_moveIndex = 0;
+
+		//Partition so the winning moves come first
+		g_winningNoisyCount = 0;
+		for (int i = 0; i < g_moveCount; ++i)
+		{
+			const Move move = g_moves[i];
+			const BoardIndex0x88 to = move.GetMoveTo();
+
+			//Most valuable victim, least valuable attacker. Promotions count the piece gained.
+			int victimValue = Piece::GetPieceValue(g_board.GetSquarePieceType(to));
+			if (move.IsEnpassant()) victimValue = Piece::GetPieceValue(Piece::PieceTypePawn);
+			if (move.IsPromotion()) victimValue += Piece::GetPieceValue(move.GetPromoteTo());
+			g_scores[i] = victimValue * 16 - Piece::GetPieceValue(g_board.GetSquarePieceType(move.GetMoveFrom()));
+
+			if (IsWinningNoisyMove(move))
+			{
+				const int score = g_scores[i];
+				g_moves[i] = g_moves[g_winningNoisyCount];
+				g_scores[i] = g_scores[g_winningNoisyCount];
+				g_moves[g_winningNoisyCount] = move;
+				g_scores[g_winningNoisyCount] = score;
+				++g_winningNoisyCount;
+			}
+		}
+	}
+
+	bool MovePicker::IsWinningNoisyMove(const Move& move) const
+	{
+		if (move.IsPromotion())
+		{
+			return move.GetPromoteTo() == Piece::PieceTypeQueen;
+		}
+
+		if (move.IsEnpassant()) return true; //Pawn takes pawn
+
+		const BoardIndex0x88 to = move.GetMoveTo();
+		const int attackerValue = Piece::GetPieceValue(g_board.GetSquarePieceType(move.GetMoveFrom()));
+		const int victimValue = Piece::GetPieceValue(g_board.GetSquarePieceType(to));
+		if (victimValue >= attackerValue) return true;
+
+		//Losing the capturing piece only matters if the exchange on the square loses material
+		return g_board.SeeGreaterOrEqual(move, 0);
+	}
+
+	void MovePicker::SelectBestMove(int end)
+	{
+		int best = g_moveIndex;
+		for (int i = g_moveIndex + 1; i < end; ++i)
+		{
+			if (g_scores[i] > g_scores[best]) best = i;
+		}
+
+		if (best != g_moveIndex)
+		{
+			const Move move = g_moves[best];
+			const int score = g_scores[best];
+			g_moves[best] = g_moves[g_moveIndex];
+			g_scores[best] = g_scores[g_moveIndex];
+			g_moves[g_moveIndex] = move;
+			g_scores[g_moveIndex] = score;
+		}
+	}
+}
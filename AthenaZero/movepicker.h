@@ -0,0 +1,120 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains code related to picking moves in stages. Moves are only
+	generated when the earlier stages have been tried, so a search that cuts off
+	early never generates the quiet moves.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATHENAZERO_ENGINE_MOVEPICKER
+#define ATHENAZERO_ENGINE_MOVEPICKER
+
+#include "board.h"
+#include "move.h"
+#include "constants.h"
+
+namespace ATHENAZEROENG
+{
+	class MovePicker
+	{
+	public:
+		/*
+			The stages, in the order they are worked through.
+		*/
+		static constexpr int StageHashMove = 0;
+		static constexpr int StageGenerateNoisy = 1;
+		static constexpr int StageWinningNoisy = 2;
+		static constexpr int StageRemainingNoisy = 3;
+		static constexpr int StageGenerateQuiet = 4;
+		static constexpr int StageQuiet = 5;
+		static constexpr int StageDone = 6;
+
+		/*
+			Creates a picker for the board's current position. The board must not be changed
+			while moves are being picked, other than making a picked move and unmaking it
+			again before picking the next.
+
+			board: The board.
+			hashMove: A move to try first (e.g. from the hash table) or a null move (Move()) if
+					  there is none. Must be pseudo legal in the position.
+		*/
+		MovePicker(Board& board, const Move& hashMove);
+
+		/*
+			Gets the next move. Moves are pseudo legal so should be made with Board::MakeMove().
+			The stages are:
+				1. The hash move.
+				2. Winning captures and queen promotions, most valuable victim first. A capture
+				   is winning if the victim is worth at least the capturing piece or the exchange
+				   on the square does not lose material (Board::SeeGreaterOrEqual()).
+				3. The remaining captures and under promotions.
+				4. Quiet moves.
+
+			move: Set to the next move.
+
+			Returns: True if a move was returned, false when there are no more moves.
+		*/
+		bool NextMove(Move& move);
+
+		/*
+			Gets the current stage (StageXXX).
+		*/
+		inline int GetStage() const
+		{
+			return g_stage;
+		}
+
+	private:
+
+		/*
+			Generates the noisy moves, scores them and moves the losing ones to the end of
+			the list for StageRemainingNoisy.
+		*/
+		void GenerateNoisyMoves();
+
+		/*
+			Determines if a noisy move is expected to win material (see NextMove()).
+		*/
+		bool IsWinningNoisyMove(const Move& move) const;
+
+		/*
+			Gets the index of the best scored move from g_moveIndex up to (not including) end
+			and swaps it to g_moveIndex.
+		*/
+		void SelectBestMove(int end);
+
+		Board& g_board;
+
+		Move g_hashMove;
+
+		int g_stage{ StageHashMove };
+
+		Move g_moves[MaxMovesInPosition];
+
+		//Ordering scores for the noisy moves, higher first
+		int g_scores[MaxMovesInPosition];
+
+		int g_moveCount{ 0 };
+
+		//The next move to return from g_moves
+		int g_moveIndex{ 0 };
+
+		//Noisy moves before this index are winning, those from it are the remaining ones
+		int g_winningNoisyCount{ 0 };
+	};
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains a fixed size binary encoding of a position (32 bytes) for
+	datasets and caches. It is written and read by Board without any text parsing.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATHENAZERO_ENGINE_PACKEDPOSITION
+#define ATHENAZERO_ENGINE_PACKEDPOSITION
+
+#include <type_traits>
+
+#include "piece.h"
+#include "typedefs.h"
+#include "bitboardlib.h"
+
+namespace ATHENAZEROENG
+{
+	/*
+		A position packed into 32 bytes. The occupied squares are one bitboard and the piece on
+		each occupied square is a nibble, in square order (a1 first) with the first piece in the
+		low nibble. A nibble is the piece index (Piece::PieceIndexXXX) plus the colour index
+		(Piece::ColourIndexXXX) times 8. Every byte is set (unused nibbles and Reserved are 0) so
+		equal positions are equal byte for byte and can be hashed or compared with memcmp.
+		Use Board::GetPackedPosition() and Board::SetPositionFromPacked() to convert.
+	*/
+	class PackedPosition
+	{
+	public:
+		//The most pieces that can be held, enough for any position reachable in a game
+		static constexpr int MaxPieces = 32;
+
+		//The colour index is held above the 3 bits of the piece index
+		static constexpr int NibbleColourShift = 3;
+
+		//The occupied squares (bit 0 = a1)
+		Bitboard Occupancy{ 0 };
+
+		//A nibble per occupied square
+		unsigned char Pieces[MaxPieces / 2]{};
+
+		//Starts at zero. Inceremented after every ply, reset to 0 after a pawn move or capture.
+		unsigned short HalfMoveClock{ 0 };
+
+		//Starts at 1 and increments after black's move.
+		unsigned short FullMoveNumber{ 1 };
+
+		//Piece::ColourIndexWhite or Piece::ColourIndexBlack
+		unsigned char ColourToMove{ Piece::ColourIndexWhite };
+
+		//Combination of the BoardState::CastleXXX values
+		unsigned char CastlingRights{ 0 };
+
+		//The square passed over by a double pawn move (0-63), NullSquare64 if none
+		unsigned char EnpassantTargetSquare{ NullSquare64 };
+
+		//Always 0, makes the padding explicit
+		unsigned char Reserved{ 0 };
+
+		/*
+			Gets the nibble of the nth occupied square.
+		*/
+		inline int GetPieceNibble(const int n) const
+		{
+			return (Pieces[n >> 1] >> ((n & 1) * 4)) & 15;
+		}
+
+		/*
+			Sets the nibble of the nth occupied square. The nibble must be 0 beforehand.
+		*/
+		inline void SetPieceNibble(const int n, const int nibble)
+		{
+			Pieces[n >> 1] |= static_cast<unsigned char>(nibble << ((n & 1) * 4));
+		}
+	};
+
+	static_assert(std::is_trivially_copyable<PackedPosition>::value, "PackedPosition must be trivially copyable");
+	static_assert(sizeof(PackedPosition) == 32, "PackedPosition must be 32 bytes");
+}
+
+#endif
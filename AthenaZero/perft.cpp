@@ -21,12 +21,19 @@
 #include "perftresults.h"
 #include "perftresult.h"
 #include "board.h"
+#include "boardbitboard.h"
 #include "perftinternalstats.h"
 #include "move.h"
 #include "perfttest.h"
 #include "perftcount.h"
 #include "timer.h"
+#include "packedposition.h"
+#include "movepicker.h"
+#include "fenfile.h"
 #include <string>
+#include <cstring>
+#include <algorithm>
+#include <utility>
 #include <iostream>
 
 namespace ATHENAZEROENG
@@ -80,8 +87,13 @@ namespace ATHENAZEROENG
 				result.EnPassantCount().SetIsRecorded(false);
 				result.CastleCount().SetIsRecorded(false);
 				result.PromotionCount().SetIsRecorded(false);
-				result.CheckCount().SetIsRecorded(false);
-				result.CheckmateCount().SetIsRecorded(false);
+
+				if (g_boardType != BoardType0x88 || g_useBulkCounting)
+				{
+					//Only the 0x88 Board counts checks (see Board::GivesCheck()), and not when bulk counting
+					result.CheckCount().SetIsRecorded(false);
+					result.CheckmateCount().SetIsRecorded(false);
+				}
 
 				results.AddResult(result);
 
@@ -97,7 +109,88 @@ namespace ATHENAZEROENG
 
 	PerftResult Perft::RunPerftTest(const int depth, const std::string& fen, const std::string& testName)
 	{
+		if (g_boardType == BoardTypeBitboard)
+		{
+			return RunPerftTestOnBoard<BoardBitboard>(depth, fen, testName);
+		}
+
+		return RunPerftTestOnBoard<Board>(depth, fen, testName);
+	}
+
+	bool Perft::RunFenFileTests(const std::string& directory)
+	{
+		//The valid lines of fenfile.epd in order, the third has the side not to move in check
+		const std::string fens[] = {
+			"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+			"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+			"4k3/8/8/8/8/8/8/4R1K1 w - - 0 1",
+			"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1" };
+		constexpr size_t fenCount = 4;
+		constexpr size_t checkIndex = 2;
+		constexpr size_t nonBlankLineCount = 6;
+
 		Board board;
+		FenFile file;
+
+		for (int i = 0; i < 2; ++i)
+		{
+			const bool validate = i == 1;
+			if (!file.Open(directory + "fenfile.epd")) return false;
+
+			std::vector<std::string> loaded;
+			size_t invalidCount = 0;
+			const size_t validCount = file.LoadPositions(
+				board,
+				FenFile::FormatEpd,
+				validate,
+				[&loaded](Board& position) { loaded.push_back(position.GetPositionAsFen()); },
+				invalidCount);
+
+			//Blank lines are skipped, the others are either valid or invalid
+			if (validCount != loaded.size() || validCount + invalidCount != nonBlankLineCount) return false;
+
+			size_t expected = 0;
+			for (size_t j = 0; j < fenCount; ++j)
+			{
+				if (validate && j == checkIndex) continue;
+				if (expected == loaded.size() || loaded[expected] != fens[j]) return false;
+				++expected;
+			}
+			if (expected != loaded.size()) return false;
+
+			//Packing loads the same positions
+			file.Rewind();
+			std::vector<PackedPosition> packed;
+			if (file.LoadPackedPositions(board, FenFile::FormatEpd, validate, packed, invalidCount) != validCount) return false;
+			if (packed.size() != validCount || validCount + invalidCount != nonBlankLineCount) return false;
+		}
+
+		//An empty file opens with no lines
+		if (!file.Open(directory + "empty.epd") || file.GetSize() != 0) return false;
+		size_t invalidCount = 1;
+		if (file.LoadPositions(board, FenFile::FormatEpd, true, [](Board&) {}, invalidCount) != 0 || invalidCount != 0) return false;
+
+		//A missing file does not open
+		if (file.Open(directory + "missing.epd") || file.GetSize() != 0) return false;
+
+		return true;
+	}
+
+	void Perft::ConfigureBoard(Board& board)
+	{
+		(void)board;
+	}
+
+	void Perft::ConfigureBoard(BoardBitboard& board)
+	{
+		board.SetUseCopyMake(g_useCopyMake);
+	}
+
+	template <class TBoard>
+	PerftResult Perft::RunPerftTestOnBoard(const int depth, const std::string& fen, const std::string& testName)
+	{
+		TBoard board;
+		ConfigureBoard(board);
 		if (!board.SetPositionFromFen(fen))
 		{
 			PerftResult result(depth, fen, testName, 0.0);
@@ -111,7 +204,7 @@ namespace ATHENAZEROENG
 
 		Timer timer;
 
-		Search(board, stats, depth);
+		StartSearch(board, stats, depth);
 
 		double elapsedTimeSeconds = timer.ElapsedTimeSeconds();
 
@@ -120,14 +213,17 @@ namespace ATHENAZEROENG
 
 		std::string finalPosition = board.GetPositionAsFen();
 
-		result.SetIntergityCheckPassed(initalPosition == finalPosition);
+		result.SetIntergityCheckPassed(initalPosition == finalPosition && CheckIntegrity(board));
 
 		result.NodeCount().SetActualCount(stats.Nodes);
+		result.CheckCount().SetActualCount(stats.Checks);
+		result.CheckmateCount().SetActualCount(stats.Checkmates);
 
 		return result;
 	}
 
-	void Perft::Search(Board& board, PerftInternalStats& stats, int depth)
+	template <class TBoard>
+	void Perft::Search(TBoard& board, PerftInternalStats& stats, int depth)
 	{
 		if (depth == 0)
 		{
@@ -138,6 +234,29 @@ namespace ATHENAZEROENG
 		Move moves[255];
 		int moveCount = 0;
 
+		if (depth == 1 && g_useBulkCounting)
+		{
+			board.GenerateLegalMoves(moves, moveCount);
+			stats.Nodes += moveCount;
+			return;
+		}
+
+		if (g_useLegalMoveGeneration)
+		{
+			board.GenerateLegalMoves(moves, moveCount);
+
+			for (int i = 0; i < moveCount; ++i)
+			{
+				if (board.MakeLegalMove(moves[i]))
+				{
+					Search(board, stats, depth - 1);
+					board.UnMakeMove();
+				}
+			}
+
+			return;
+		}
+
 		board.GeneratePseudoLegalMoves(moves, moveCount);
 
 		for (int i = 0; i < moveCount; ++i)
@@ -150,6 +269,431 @@ namespace ATHENAZEROENG
 		}
 	}
 
+	template <int Us>
+	void Perft::SearchColour(Board& board, PerftInternalStats& stats, int depth)
+	{
+		if (depth == 0)
+		{
+			++stats.Nodes;
+			return;
+		}
+
+		if (depth == 1 && g_useBulkCounting)
+		{
+			stats.Nodes += board.CountLegalMoves<Us>();
+			return;
+		}
+
+		Move moves[255];
+		int moveCount = 0;
+
+		if (g_useLegalMoveGeneration)
+		{
+			board.GenerateLegalMoves<Us>(moves, moveCount);
+
+			for (int i = 0; i < moveCount; ++i)
+			{
+				const bool givesCheck = depth == 1 && board.GivesCheck(moves[i]);
+				if (board.MakeLegalMove<Us>(moves[i]))
+				{
+					if (givesCheck) CountCheck<Piece::OtherColour(Us)>(board, stats);
+					SearchColour<Piece::OtherColour(Us)>(board, stats, depth - 1);
+					board.UnMakeMove();
+				}
+			}
+
+			return;
+		}
+
+		board.GeneratePseudoLegalMoves<Us>(moves, moveCount);
+
+		for (int i = 0; i < moveCount; ++i)
+		{
+			const bool givesCheck = depth == 1 && board.GivesCheck(moves[i]);
+			if (board.MakeMove<Us>(moves[i]))
+			{
+				if (givesCheck) CountCheck<Piece::OtherColour(Us)>(board, stats);
+				SearchColour<Piece::OtherColour(Us)>(board, stats, depth - 1);
+				board.UnMakeMove();
+			}
+		}
+	}
+
+	template <int Us>
+	void Perft::CountCheck(Board& board, PerftInternalStats& stats)
+	{
+		++stats.Checks;
+
+		if (board.CountLegalMoves<Us>() == 0) ++stats.Checkmates;
+	}
+
+	void Perft::StartSearch(Board& board, PerftInternalStats& stats, int depth)
+	{
+		if (board.GetColourToMove() == Piece::PieceColourWhite)
+		{
+			SearchColour<Piece::PieceColourWhite>(board, stats, depth);
+		}
+		else
+		{
+			SearchColour<Piece::PieceColourBlack>(board, stats, depth);
+		}
+	}
+
+	void Perft::StartSearch(BoardBitboard& board, PerftInternalStats& stats, int depth)
+	{
+		Search(board, stats, depth);
+	}
+
+	bool Perft::CheckIntegrity(Board& board)
+	{
+		Board roundTrip;
+		ZobristKey keys[IntegrityWalkLength + 1];
+		Move walked[IntegrityWalkLength];
+		const std::string startFen = board.GetPositionAsFen();
+		int ply = 0;
+		bool passed = true;
+
+		//Fixed seed so a failure can be repeated
+		unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+		auto random = [&seed]()
+		{
+			//xorshift64*
+			seed ^= seed >> 12;
+			seed ^= seed << 25;
+			seed ^= seed >> 27;
+			return seed * 2685821657736338717ULL;
+		};
+
+		while (true)
+		{
+			keys[ply] = board.GetKey();
+			passed = CheckPositionIntegrity(board, roundTrip, keys, ply);
+			if (passed && ply % IntegritySweepInterval == 0) passed = CheckPseudoLegalIntegrity(board);
+			if (passed && !board.IsInCheck())
+			{
+				passed = CheckNullMoveIntegrity(board);
+				if (passed && ply == 0) passed = CheckNullMoveStackIntegrity(board, roundTrip);
+			}
+			if (!passed || ply == IntegrityWalkLength) break;
+
+			Move moves[255];
+			int moveCount = 0;
+			board.GeneratePseudoLegalMoves(moves, moveCount);
+
+			for (int i = 0; i < moveCount && passed; ++i)
+			{
+				passed = CheckMoveIntegrity(board, moves[i]);
+			}
+
+			passed = passed && CheckCapturesIntegrity(board);
+			passed = passed && CheckMovePickerIntegrity(board, Move());
+			if (passed && moveCount > 0)
+			{
+				const Move& hashMove = moves[random() % static_cast<unsigned long long>(moveCount)];
+				passed = CheckMovePickerIntegrity(board, hashMove);
+			}
+			if (!passed) break;
+
+			//Half the time move the piece moved two plies ago back, so the walk repeats positions
+			bool isMade = false;
+			if (ply >= 2 && (random() & 1) != 0)
+			{
+				const Move& previous = walked[ply - 2];
+				for (int i = 0; i < moveCount && !isMade; ++i)
+				{
+					if (moves[i].GetMoveFrom() == previous.GetMoveTo() &&
+						moves[i].GetMoveTo() == previous.GetMoveFrom() &&
+						!moves[i].IsCapture() &&
+						board.MakeMove(moves[i]))
+					{
+						walked[ply] = moves[i];
+						isMade = true;
+					}
+				}
+			}
+
+			//Otherwise the first legal move from a random start
+			const int start = moveCount == 0 ? 0 : static_cast<int>(random() % static_cast<unsigned long long>(moveCount));
+			for (int i = 0; i < moveCount && !isMade; ++i)
+			{
+				const Move& move = moves[(start + i) % moveCount];
+				if (board.MakeMove(move))
+				{
+					walked[ply] = move;
+					isMade = true;
+				}
+			}
+
+			//Checkmate or stalemate
+			if (!isMade) break;
+
+			++ply;
+		}
+
+		passed = passed && CheckCopyIntegrity(board, roundTrip, ply, startFen);
+
+		for (int i = 0; i < ply; ++i)
+		{
+			board.UnMakeMove();
+		}
+
+		return passed;
+	}
+
+	bool Perft::CheckIntegrity(BoardBitboard& board)
+	{
+		(void)board;
+		return true;
+	}
+
+	bool Perft::CheckPositionIntegrity(Board& board, Board& roundTrip, const ZobristKey* keys, const int ply)
+	{
+		//Incrementally updated keys
+		if (board.GetKey() != board.CalculateKey()) return false;
+		if (board.GetPawnKey() != board.CalculatePawnKey()) return false;
+		if (board.GetMaterialSignature() != board.CalculateMaterialSignature()) return false;
+
+		//Repetition, the same key an even number of plies back since the last irreversible move
+		bool isRepetition = false;
+		for (int back = 2; back <= ply && back <= board.GetHalfMoveClock(); back += 2)
+		{
+			if (keys[ply - back] == keys[ply]) isRepetition = true;
+		}
+		if (board.IsRepetition() != isRepetition) return false;
+
+		//Bulk count
+		Move moves[255];
+		int moveCount = 0;
+		board.GenerateLegalMoves(moves, moveCount);
+		if (board.CountLegalMoves() != moveCount) return false;
+
+		//FEN, both writers and the allocation free parser
+		const std::string fen = board.GetPositionAsFen();
+		char buffer[Board::FenBufferLength];
+		const size_t length = board.WritePositionAsFen(buffer);
+		if (fen != std::string(buffer, length)) return false;
+
+		if (!roundTrip.SetPositionFromFen(buffer, length, true)) return false;
+		if (roundTrip.GetPositionAsFen() != fen || roundTrip.GetKey() != board.GetKey()) return false;
+
+		//Packed position, packing the unpacked position must give the same bytes
+		PackedPosition packed;
+		PackedPosition repacked;
+		if (!board.GetPackedPosition(packed)) return false;
+		if (!roundTrip.SetPositionFromPacked(packed, true)) return false;
+		if (roundTrip.GetPositionAsFen() != fen || roundTrip.GetKey() != board.GetKey()) return false;
+		if (!roundTrip.GetPackedPosition(repacked) || std::memcmp(&packed, &repacked, sizeof(PackedPosition)) != 0) return false;
+
+		return true;
+	}
+
+	bool Perft::CheckNullMoveIntegrity(Board& board)
+	{
+		const ZobristKey key = board.GetKey();
+		const std::string fen = board.GetPositionAsFen();
+
+		if (!board.MakeNullMove()) return false;
+		bool passed = board.GetKey() == board.CalculateKey() && !board.IsRepetition();
+
+		//Back to the same position, but not reached by real moves so not a repetition
+		if (board.MakeNullMove())
+		{
+			passed = passed && board.GetKey() == board.CalculateKey() && !board.IsRepetition();
+			board.UnMakeNullMove();
+		}
+		else
+		{
+			passed = false;
+		}
+
+		board.UnMakeNullMove();
+		return passed && board.GetKey() == key && board.GetPositionAsFen() == fen;
+	}
+
+	bool Perft::CheckNullMoveStackIntegrity(Board& board, Board& full)
+	{
+		//The position with the largest move counters it can be set with, one more must be refused
+		std::string position = board.GetPositionAsFen();
+		position.erase(position.rfind(' ', position.rfind(' ') - 1));
+		const std::string largest = std::to_string(Board::MaxSetMoveCounter);
+		const std::string tooLarge = std::to_string(Board::MaxSetMoveCounter + 1);
+		if (full.SetPositionFromFen(position + " " + tooLarge + " 1")) return false;
+		if (full.SetPositionFromFen(position + " 0 " + tooLarge)) return false;
+
+		const std::string fen = position + " " + largest + " " + largest;
+		if (!full.SetPositionFromFen(fen) || full.GetPositionAsFen() != fen) return false;
+		const ZobristKey key = full.GetKey();
+
+		int made = 0;
+		while (made <= FixedUnmakeMoveListCapacity && full.MakeNullMove())
+		{
+			++made;
+		}
+
+		//A full stack takes the half move clock to the largest value that can be stored
+		const bool isFull = made == FixedUnmakeMoveListCapacity && full.GetHalfMoveClock() == Board::MaxMoveCounter;
+
+		for (int i = 0; i < made; ++i)
+		{
+			full.UnMakeNullMove();
+		}
+
+		return isFull && full.GetKey() == key && full.GetPositionAsFen() == fen;
+	}
+
+	bool Perft::CheckCopyIntegrity(Board& board, Board& assigned, const int ply, const std::string& startFen)
+	{
+		const std::string fen = board.GetPositionAsFen();
+
+		Board copied(board);
+		if (!IsSameBoard(board, copied)) return false;
+
+		Board moved(std::move(copied));
+		if (!IsSameBoard(board, moved)) return false;
+
+		assigned = board;
+		if (!IsSameBoard(board, assigned)) return false;
+
+		copied = std::move(moved);
+		if (!IsSameBoard(board, copied)) return false;
+
+		//The copies hold the line so can unmake it, leaving the board alone
+		for (int i = 0; i < ply; ++i)
+		{
+			copied.UnMakeMove();
+			assigned.UnMakeMove();
+		}
+
+		if (copied.GetPositionAsFen() != startFen || copied.GetKey() != copied.CalculateKey()) return false;
+		if (assigned.GetPositionAsFen() != startFen || assigned.GetKey() != assigned.CalculateKey()) return false;
+		return board.GetPositionAsFen() == fen;
+	}
+
+	bool Perft::IsSameBoard(Board& board, Board& copy)
+	{
+		return copy.GetPositionAsFen() == board.GetPositionAsFen() &&
+			copy.GetKey() == board.GetKey() &&
+			copy.GetPawnKey() == board.GetPawnKey() &&
+			copy.GetMaterialSignature() == board.GetMaterialSignature() &&
+			copy.CountLegalMoves() == board.CountLegalMoves() &&
+			copy.IsRepetition() == board.IsRepetition();
+	}
+
+	bool Perft::CheckMoveIntegrity(Board& board, const Move& move)
+	{
+		//Hash and killer moves are tested with IsPseudoLegal()
+		if (!board.IsPseudoLegal(move)) return false;
+
+		//The threshold test must pass at the exchange value and fail above it
+		if (move.IsCapture() || move.IsPromotion())
+		{
+			const int see = board.SEE(move);
+			if (!board.SeeGreaterOrEqual(move, see) || board.SeeGreaterOrEqual(move, see + 1)) return false;
+		}
+
+		const bool givesCheck = board.GivesCheck(move);
+		if (!board.MakeMove(move)) return true; //Not legal
+
+		const bool isInCheck = board.IsInCheck();
+		board.UnMakeMove();
+		if (givesCheck != isInCheck) return false;
+
+		char text[Move::StandardFormatBufferLength];
+		const size_t length = move.WriteMoveAsStandardFormat(text);
+		return board.ParseMove(text, length) == move;
+	}
+
+	bool Perft::CheckPseudoLegalIntegrity(Board& board)
+	{
+		constexpr int moveValueCount = 1 << 16;
+
+		Move moves[255];
+		int moveCount = 0;
+		board.GenerateMoves(Board::MoveGenerationAll, moves, moveCount);
+
+		std::vector<bool> isGenerated(moveValueCount, false);
+		for (int i = 0; i < moveCount; ++i)
+		{
+			isGenerated[moves[i].GetData()] = true;
+		}
+
+		//Any 16 bit value can come out of the hash table, so test them all
+		for (int data = 0; data < moveValueCount; ++data)
+		{
+			const Move move(static_cast<unsigned short>(data));
+			if (board.IsPseudoLegal(move) != isGenerated[data]) return false;
+		}
+
+		return true;
+	}
+
+	bool Perft::CheckMovePickerIntegrity(Board& board, const Move& hashMove)
+	{
+		Move moves[MaxMovesInPosition];
+		int moveCount = 0;
+		board.GenerateMoves(Board::MoveGenerationAll, moves, moveCount);
+
+		MovePicker picker(board, hashMove);
+		Move picked[MaxMovesInPosition];
+		int pickedCount = 0;
+		Move move;
+		while (pickedCount < MaxMovesInPosition && picker.NextMove(move))
+		{
+			picked[pickedCount++] = move;
+		}
+
+		if (pickedCount != moveCount || picker.NextMove(move)) return false;
+		if (!hashMove.IsNull() && (pickedCount == 0 || picked[0] != hashMove)) return false;
+
+		//Same moves in any order, and as the generated moves are all different no move was picked twice
+		auto byData = [](const Move& a, const Move& b) { return a.GetData() < b.GetData(); };
+		std::sort(moves, moves + moveCount, byData);
+		std::sort(picked, picked + pickedCount, byData);
+		for (int i = 0; i < moveCount; ++i)
+		{
+			if (moves[i] != picked[i]) return false;
+			if (i > 0 && moves[i] == moves[i - 1]) return false;
+		}
+
+		return true;
+	}
+
+	bool Perft::CheckCapturesIntegrity(Board& board)
+	{
+		Move moves[MaxMovesInPosition];
+		int moveCount = 0;
+		board.GenerateMoves(Board::MoveGenerationNoisy, moves, moveCount);
+
+		Move captures[MaxMovesInPosition];
+		int captureCount = 0;
+		board.GenerateCaptures(captures, captureCount);
+
+		if (captureCount != moveCount) return false;
+
+		//Most valuable victim first
+		int previousValue = Piece::GetPieceValue(Piece::PieceTypeQueen);
+		for (int i = 0; i < captureCount; ++i)
+		{
+			const Move& move = captures[i];
+			int value = 0;
+			if (move.IsEnpassant()) value = Piece::GetPieceValue(Piece::PieceTypePawn);
+			else if (move.IsCapture()) value = Piece::GetPieceValue(board.GetSquarePieceType(move.GetMoveTo()));
+
+			if (value > previousValue) return false;
+			previousValue = value;
+		}
+
+		auto byData = [](const Move& a, const Move& b) { return a.GetData() < b.GetData(); };
+		std::sort(moves, moves + moveCount, byData);
+		std::sort(captures, captures + captureCount, byData);
+		for (int i = 0; i < moveCount; ++i)
+		{
+			if (moves[i] != captures[i]) return false;
+		}
+
+		return true;
+	}
+
 	void Perft::SetupPerftTestsInitialPosition()
 	{
 		//rnbq1k1r/pp1P1ppp/2p5/8/1bB5/7P/PPP1NnP1/RNBQK2R w KQ - 1 2
@@ -25,6 +25,7 @@
 
 #include "perftresults.h"
 #include "board.h"
+#include "boardbitboard.h"
 #include "perftinternalstats.h"
 #include "perfttest.h"
 #include <vector>
@@ -34,10 +35,57 @@ namespace ATHENAZEROENG
 	class Perft
 	{
 	public:
+		//Runs the tests on the 0x88 Board
+		static constexpr int BoardType0x88 = 0;
+		//Runs the tests on BoardBitboard
+		static constexpr int BoardTypeBitboard = 1;
+
 		/*
 			Creates a new instance of the class.
 		*/
 		Perft();
+
+		/*
+			Sets the board representation used to run the tests. Must be one of:
+				* BoardType0x88 (the default)
+				* BoardTypeBitboard
+		*/
+		inline void SetBoardType(const int boardType)
+		{
+			g_boardType = boardType;
+		}
+
+		/*
+			Sets whether the tests use the legal move generator (GenerateLegalMoves() and
+			MakeLegalMove()) rather than generating pseudo legal moves and rejecting
+			illegal ones in MakeMove(). Defaults to false.
+		*/
+		inline void SetUseLegalMoveGeneration(const bool useLegalMoveGeneration)
+		{
+			g_useLegalMoveGeneration = useLegalMoveGeneration;
+		}
+
+		/*
+			Sets whether BoardBitboard undoes moves by copy-make (copying the whole position
+			before each move) rather than its unmake list. Ignored by the 0x88 Board.
+			Defaults to false.
+		*/
+		inline void SetUseCopyMake(const bool useCopyMake)
+		{
+			g_useCopyMake = useCopyMake;
+		}
+
+		/*
+			Sets whether the last ply is bulk counted. At depth 1 the legal moves are counted
+			(Board::CountLegalMoves(), or the length of the legal move list for BoardBitboard)
+			rather than each one made and unmade. Checks and checkmates are not counted.
+			Defaults to false.
+		*/
+		inline void SetUseBulkCounting(const bool useBulkCounting)
+		{
+			g_useBulkCounting = useBulkCounting;
+		}
+
 		/*
 			Runs all perft tests.
 
@@ -48,11 +96,38 @@ namespace ATHENAZEROENG
 		PerftResults RunAllPerftTests(
 			int maxDepth,
 			bool stopOnFirstFailure);
+
+		/*
+			Loads the FEN file test files with FenFile and checks the positions loaded, with and
+			without validation. fenfile.epd has CRLF and LF line endings, blank lines, lines
+			that are not positions, a position that is only invalid when validated and no line
+			ending on its last line. empty.epd is empty and missing.epd must not exist.
+
+			directory: The directory holding the files, ending in a path separator.
+			Returns: True if every file loaded as expected, false otherwise.
+		*/
+		bool RunFenFileTests(const std::string& directory);
 	private:
 		std::ofstream* g_logfile;
 
 		std::vector<PerftTest> g_perftTests;
 
+		int g_boardType{ BoardType0x88 };
+
+		bool g_useLegalMoveGeneration{ false };
+
+		bool g_useCopyMake{ false };
+
+		bool g_useBulkCounting{ false };
+
+		/*
+			Applies the options that only apply to one board representation.
+
+			board: The newly created board.
+		*/
+		void ConfigureBoard(Board& board);
+		void ConfigureBoard(BoardBitboard& board);
+
 		/*
 			Runs a perft test.
 
@@ -64,14 +139,189 @@ namespace ATHENAZEROENG
 		*/
 		PerftResult RunPerftTest(const int depth, const std::string& fen, const std::string& testName);
 
+		/*
+			Runs a perft test on the specified board representation.
+
+			TBoard: Board or BoardBitboard.
+			depth: The depth in ply.
+			fen: The starting position.
+			testName: The name of the test.
+
+			Returns: The result. On error returns a blank class which will set nodes (expected and actual) to 0.
+		*/
+		template <class TBoard>
+		PerftResult RunPerftTestOnBoard(const int depth, const std::string& fen, const std::string& testName);
+
 		/*
 			Performs the recursive searc.
 
+			TBoard: Board or BoardBitboard.
+			board: The board set to the correct perft starting position.
+			stats: The stats.
+			depth: The depth to search to.
+		*/
+		template <class TBoard>
+		void Search(TBoard& board, PerftInternalStats& stats, int depth);
+
+		/*
+			Performs the recursive search on the 0x88 Board using the colour templated
+			move generation and make methods, so the side to move is known at compile time.
+
+			Us: The side to move (Piece::PieceColourXXX).
+			board: The board set to the correct perft starting position.
+			stats: The stats.
+			depth: The depth to search to.
+		*/
+		template <int Us>
+		void SearchColour(Board& board, PerftInternalStats& stats, int depth);
+
+		/*
+			Counts a check at the last ply, and a checkmate if the side in check has no
+			legal moves.
+
+			Us: The side in check (Piece::PieceColourXXX), i.e. the side to move.
+			board: The board after the checking move.
+			stats: The stats.
+		*/
+		template <int Us>
+		void CountCheck(Board& board, PerftInternalStats& stats);
+
+		/*
+			Starts the recursive search. The 0x88 Board tests the side to move once and
+			uses SearchColour(), BoardBitboard uses Search().
+
 			board: The board set to the correct perft starting position.
 			stats: The stats.
 			depth: The depth to search to.
 		*/
-		void Search(Board& board, PerftInternalStats& stats, int depth);
+		void StartSearch(Board& board, PerftInternalStats& stats, int depth);
+		void StartSearch(BoardBitboard& board, PerftInternalStats& stats, int depth);
+
+		//The number of plies walked by CheckIntegrity()
+		static constexpr int IntegrityWalkLength = 64;
+
+		//Every move value is tested with IsPseudoLegal() at every this many plies of the walk
+		static constexpr int IntegritySweepInterval = 16;
+
+		/*
+			Checks the parts of the 0x88 Board that the search does not use agree with move
+			generation and make/unmake. Walks up to IntegrityWalkLength plies from the test
+			position along a fixed pseudo random line, which often steps a piece back so
+			positions repeat. Each position is checked with CheckPositionIntegrity() and each of
+			its pseudo legal moves with CheckMoveIntegrity(). CheckCapturesIntegrity() is run,
+			then CheckMovePickerIntegrity() with no hash move and with one of the moves at
+			random, and every IntegritySweepInterval plies CheckPseudoLegalIntegrity(). When not
+			in check CheckNullMoveIntegrity() is run, and at the test position
+			CheckNullMoveStackIntegrity(). At the end of the walk CheckCopyIntegrity() is run,
+			then the walk is unmade. BoardBitboard has none of these parts so always passes.
+
+			board: The board set to the perft starting position.
+			Returns: True if every check passed, false otherwise.
+		*/
+		bool CheckIntegrity(Board& board);
+		bool CheckIntegrity(BoardBitboard& board);
+
+		/*
+			Checks a position. The incremental keys must equal the keys calculated from scratch,
+			IsRepetition() must agree with a scan of the walked keys, CountLegalMoves() must equal
+			the number of legal moves, and the FEN (written by WritePositionAsFen()) and the
+			packed position must both set the same position on another board.
+
+			board: The board.
+			roundTrip: The board the FEN and packed position are set on.
+			keys: The key of each position walked, up to and including this one.
+			ply: The index of this position in keys.
+			Returns: True if every check passed, false otherwise.
+		*/
+		bool CheckPositionIntegrity(Board& board, Board& roundTrip, const ZobristKey* keys, const int ply);
+
+		/*
+			Checks a pseudo legal move. IsPseudoLegal() must accept it, SEE() must agree with
+			SeeGreaterOrEqual(), and if the move is legal GivesCheck() must agree with making it
+			and ParseMove() must read back the text written by Move::WriteMoveAsStandardFormat().
+
+			board: The board.
+			move: The move.
+			Returns: True if every check passed, false otherwise.
+		*/
+		bool CheckMoveIntegrity(Board& board, const Move& move);
+
+		/*
+			Tests every 16 bit move value with IsPseudoLegal(). It must accept exactly the moves
+			GenerateMoves(MoveGenerationAll, ...) generates.
+
+			board: The board.
+			Returns: True if the moves accepted are the moves generated, false otherwise.
+		*/
+		bool CheckPseudoLegalIntegrity(Board& board);
+
+		/*
+			Picks every move with a MovePicker. It must return each move
+			GenerateMoves(MoveGenerationAll, ...) generates exactly once, with the hash move first.
+
+			board: The board.
+			hashMove: The hash move to pick with, a pseudo legal move or a null move (Move()).
+			Returns: True if the moves picked are the moves generated, false otherwise.
+		*/
+		bool CheckMovePickerIntegrity(Board& board, const Move& hashMove);
+
+		/*
+			Checks GenerateCaptures() gives the moves GenerateMoves(MoveGenerationNoisy, ...)
+			gives, most valuable victim first. A promotion that does not capture has no victim.
+
+			board: The board.
+			Returns: True if the moves and their order are correct, false otherwise.
+		*/
+		bool CheckCapturesIntegrity(Board& board);
+
+		/*
+			Checks two null moves made in a row and unmade. The incremental key must equal the
+			key calculated from scratch after each, IsRepetition() must stop at the null moves
+			even though the position is the same as two plies before, and unmaking must restore
+			the key and FEN. Only call when the side to move is not in check.
+
+			board: The board.
+			Returns: True if every check passed, false otherwise.
+		*/
+		bool CheckNullMoveIntegrity(Board& board);
+
+		/*
+			Sets the position on another board with both move counters at
+			Board::MaxSetMoveCounter (one more must be refused), then makes null moves until
+			MakeNullMove() returns false. Exactly FixedUnmakeMoveListCapacity must be made,
+			leaving the half move clock at Board::MaxMoveCounter, and unmaking them all must
+			restore the key and FEN. Only call when the side to move is not in check.
+
+			board: The board, not changed.
+			full: The board the null moves are made on.
+			Returns: True if every check passed, false otherwise.
+		*/
+		bool CheckNullMoveStackIntegrity(Board& board, Board& full);
+
+		/*
+			Checks copies of a board part way through a line. The board is copy constructed,
+			move constructed, copy assigned and move assigned, and each copy must have the same
+			FEN, keys, legal move count and repetition state (see IsSameBoard()). Two of the
+			copies then unmake the line, which must take them back to the start position
+			without changing the board.
+
+			board: The board.
+			assigned: A board to copy assign over, overwritten.
+			ply: The number of moves made on the board since the start position.
+			startFen: The FEN of the start position.
+			Returns: True if every check passed, false otherwise.
+		*/
+		bool CheckCopyIntegrity(Board& board, Board& assigned, const int ply, const std::string& startFen);
+
+		/*
+			Determines if a copy of a board is in the same position, with the same keys, legal
+			move count and repetition state.
+
+			board: The board.
+			copy: The copy.
+			Returns: True if the same, false otherwise.
+		*/
+		bool IsSameBoard(Board& board, Board& copy);
 
 		/*
 			Sets up the perft tests from the initial position.
@@ -21,6 +21,8 @@
 #ifndef ATHENAZERO_ENGINE_PIECE
 #define ATHENAZERO_ENGINE_PIECE
 
+#include "typedefs.h"
+
 namespace ATHENAZEROENG
 {
 	class Piece
@@ -37,6 +39,147 @@ namespace ATHENAZEROENG
 		static constexpr int PieceColourWhite = 64;
 		static constexpr int PieceColourBlack = 128;
 
+		/*
+			Masks to extract the type and colour from a PackedPiece. The type and
+			colour values do not overlap so a packed piece is simply type | colour.
+		*/
+		static constexpr int PieceTypeMask = 63;
+		static constexpr int PieceColourMask = 192;
+
+		//The PackedPiece for an empty square
+		static constexpr PackedPiece PackedPieceNone = 0;
+
+		/*
+			0-based indexes for each piece type. Used where a piece type
+			indexes an array (e.g. bitboards). Each index is the bit position
+			of the equivalent PieceType value.
+		*/
+		static constexpr int PieceIndexKing = 0;
+		static constexpr int PieceIndexRook = 1;
+		static constexpr int PieceIndexKnight = 2;
+		static constexpr int PieceIndexBishop = 3;
+		static constexpr int PieceIndexQueen = 4;
+		static constexpr int PieceIndexPawn = 5;
+		static constexpr int PieceIndexNone = 6;
+
+		//Number of piece types, excluding PieceTypeNone.
+		static constexpr int PieceTypeCount = 6;
+
+		/*
+			0-based indexes for each colour. Used where a colour
+			indexes an array.
+		*/
+		static constexpr int ColourIndexWhite = 0;
+		static constexpr int ColourIndexBlack = 1;
+
+		/*
+			Converts a piece type index (PieceIndexXXX) to the piece type (PieceTypeXXX).
+			PieceIndexNone becomes PieceTypeNone.
+		*/
+		static constexpr int IndexToPieceType(int pieceIndex)
+		{
+			return pieceIndex == PieceIndexNone ? PieceTypeNone : 1 << pieceIndex;
+		}
+
+		/*
+			Converts a piece type (PieceTypeXXX) to the piece type index (PieceIndexXXX).
+			PieceTypeNone becomes PieceIndexNone.
+		*/
+		static inline int PieceTypeToIndex(int pieceType)
+		{
+			switch (pieceType)
+			{
+			case PieceTypeKing:
+				return PieceIndexKing;
+			case PieceTypeRook:
+				return PieceIndexRook;
+			case PieceTypeKnight:
+				return PieceIndexKnight;
+			case PieceTypeBishop:
+				return PieceIndexBishop;
+			case PieceTypeQueen:
+				return PieceIndexQueen;
+			case PieceTypePawn:
+				return PieceIndexPawn;
+			default:
+				return PieceIndexNone;
+			}
+		}
+
+		/*
+			Gets the value of a piece type (PieceTypeXXX) in centipawns, used by static exchange
+			evaluation and to order captures so both agree. The king is worth more than all the
+			other pieces together so it is never traded. PieceTypeNone is worth 0.
+		*/
+		static constexpr int GetPieceValue(int pieceType)
+		{
+			switch (pieceType)
+			{
+			case PieceTypeKing:
+				return 10000;
+			case PieceTypeRook:
+				return 500;
+			case PieceTypeKnight:
+				return 300;
+			case PieceTypeBishop:
+				return 300;
+			case PieceTypeQueen:
+				return 900;
+			case PieceTypePawn:
+				return 100;
+			default:
+				return 0;
+			}
+		}
+
+		/*
+			Converts a colour (PieceColourXXX) to the colour index (ColourIndexXXX).
+		*/
+		static constexpr int ColourToIndex(int pieceColour)
+		{
+			return pieceColour == PieceColourWhite ? ColourIndexWhite : ColourIndexBlack;
+		}
+
+		/*
+			Converts a colour index (ColourIndexXXX) to the colour (PieceColourXXX).
+		*/
+		static constexpr int IndexToColour(int colourIndex)
+		{
+			return colourIndex == ColourIndexWhite ? PieceColourWhite : PieceColourBlack;
+		}
+
+		/*
+			Gets the opposing colour (PieceColourXXX) of a colour (PieceColourXXX).
+		*/
+		static constexpr int OtherColour(int pieceColour)
+		{
+			return pieceColour == PieceColourWhite ? PieceColourBlack : PieceColourWhite;
+		}
+
+		/*
+			Packs a piece type (PieceTypeXXX) and colour (PieceColourXXX) into one byte.
+		*/
+		static constexpr PackedPiece Pack(int pieceType, int pieceColour)
+		{
+			return static_cast<PackedPiece>(pieceType | pieceColour);
+		}
+
+		/*
+			Gets the piece type (PieceTypeXXX) from a packed piece.
+		*/
+		static constexpr int GetPackedType(PackedPiece packedPiece)
+		{
+			return packedPiece & PieceTypeMask;
+		}
+
+		/*
+			Gets the colour (PieceColourXXX) from a packed piece. 0 for an empty square.
+		*/
+		static constexpr int GetPackedColour(PackedPiece packedPiece)
+		{
+			return packedPiece & PieceColourMask;
+		}
+
 		/*
 			The type of piece, should be one of:
 			* PieceTypeNone
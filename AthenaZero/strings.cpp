@@ -31,4 +31,23 @@ namespace ATHENAZEROENG
 		while (it != s.end() && std::isdigit(*it)) ++it;
 		return !s.empty() && it == s.end();
 	}
+
+	size_t write_unsigned(unsigned int value, char* buffer)
+	{
+		//Digits are produced lowest first so are reversed into the buffer
+		char digits[10];
+		size_t count = 0;
+		do
+		{
+			digits[count++] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		} while (value != 0);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			buffer[i] = digits[count - 1 - i];
+		}
+
+		return count;
+	}
 }
@@ -32,6 +32,15 @@ namespace ATHENAZEROENG
 		Returns: True if numeric, false oterwise
 	*/
 	bool is_number(const std::string& s);
+
+	/*
+		Writes a number in decimal without a null terminator.
+
+		value: The number.
+		buffer: At least 10 in length (the digits of the largest unsigned int).
+		Returns: The number of characters written.
+	*/
+	size_t write_unsigned(unsigned int value, char* buffer);
 }
 
 #endif
@@ -23,6 +23,24 @@
 namespace ATHENAZEROENG
 {
 	typedef unsigned int BoardIndex0x88;
+
+	//A 0x88 square stored in a single byte. Used where many squares are stored (e.g. piece lists).
+	typedef unsigned char CompactBoardIndex0x88;
+
+	//A piece type and colour in a single byte (Piece::PieceTypeXXX | Piece::PieceColourXXX). 0 is an empty square.
+	typedef unsigned char PackedPiece;
+
+	//Square index (0-63) used by the bitboard representation. a1 = 0, h8 = 63.
+	typedef unsigned int BoardIndex64;
+
+	//A set of squares, one bit per square (bit 0 = a1, bit 63 = h8).
+	typedef unsigned long long Bitboard;
+
+	//A Zobrist hash key identifying a position (pieces, side to move, castling rights and enpassant file).
+	typedef unsigned long long ZobristKey;
+
+	//The count of each piece type for each colour, 4 bits per count (see Board::GetMaterialCount()).
+	typedef unsigned long long MaterialSignature;
 }
 
 #endif
@@ -21,55 +21,59 @@
 #ifndef ATHENAZERO_ENGINE_UNMAKE
 #define ATHENAZERO_ENGINE_UNMAKE
 
+#include <type_traits>
+
 #include "board0x88lib.h"
 #include "typedefs.h"
 #include "piece.h"
+#include "move.h"
+#include "boardstate.h"
 
 namespace ATHENAZEROENG
 {
-	class UnmakeItem
+	/*
+		Holds what cannot be worked out from the move when it is undone. The side to move,
+		king locations, full move number and the piece that moved (a pawn if promoting) are
+		recovered from the move and the board, so only the irreversible state is kept.
+		Packed into 16 bytes so four fit in a cache line.
+
+		Every field is set when an item is pushed, so there are no initialisers. The item is
+		trivially default constructible and creating or copying a Board does not write the
+		whole unmake stack.
+	*/
+	class alignas(16) UnmakeItem
 	{
 	public:
-		// *** Move *** \\
-
-		//Main piece move from
-		BoardIndex0x88 MovedFrom{ Null0x88Square };
-		//Main piece move to
-		BoardIndex0x88 MovedTo{ Null0x88Square };
-		//Original piece from MovedFrom (for undoing promotion)
-		Piece OriginalPiece;
-		//Captured piece from MovedTo
-		Piece CapturedPiece;
+		//The position's Zobrist key before the move was made
+		ZobristKey Key;
 
-		//For castling (Rook move from)
-		BoardIndex0x88 MovedFrom2{ Null0x88Square };
-		//For castling (Rook move to)
-		BoardIndex0x88 MovedTo2{ Null0x88Square };
-
-		//For enpassant (square captured pawn was on)
-		BoardIndex0x88 OtherReplaceSquare{ Null0x88Square };
-		//For enpassant (actual pawn)
-		Piece OtherReplacePiece;
+		// *** Move *** \\
 
+		//The move made (Move::GetData()). The squares for castling and enpassant are derived from it.
+		unsigned short MoveData;
 
 		// *** State *** \\
 
-		//The colour to move before the move is made
-		int ColourToMove{ Piece::PieceColourWhite };
+		//BoardState::HalfMoveClock before the move was made
+		unsigned short HalfMoveClock;
+		//Captured piece from the move's to square (or the enpassant square for enpassant)
+		PackedPiece CapturedPiece;
+		//BoardState::CastlingRights before the move was made
+		unsigned char CastlingRights;
+		//BoardState::EnpassantTargetSquare before the move was made
+		CompactBoardIndex0x88 EnpassantTargetSquare;
 
-		//Castling state before move is made
-		bool CanWhiteCastleKingSide{ true };
-		bool CanWhiteCastleQueenSide{ true };
-		bool CanBlackCastleKingSide{ true };
-		bool CanBlackCastleQueenSide{ true };
-
-		//Before move is made
-		BoardIndex0x88 WhiteKingLocation0x88{ Null0x88Square };
-		BoardIndex0x88 BlackKingLocation0x88{ Null0x88Square };
-		BoardIndex0x88 EnpassantTargetSquare{ Null0x88Square };
-		int HalfMoveClock{ 0 };
-		int FullMoveNumber{ 1 };
+		/*
+			Gets the move made.
+		*/
+		inline Move GetMoveMade() const
+		{
+			return Move(MoveData);
+		}
 	};
+
+	static_assert(sizeof(UnmakeItem) <= 16, "UnmakeItem must fit in 16 bytes");
+	static_assert(std::is_trivially_default_constructible<UnmakeItem>::value, "UnmakeItem must not need initialising");
 }
 
 #endif
@@ -0,0 +1,85 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains the random keys used to build Zobrist hash keys for
+	positions.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "zobrist.h"
+
+namespace ATHENAZEROENG
+{
+	ZobristKey Zobrist::g_pieceKeys[2][Piece::PieceTypeCount][64];
+	ZobristKey Zobrist::g_blackToMoveKey;
+	ZobristKey Zobrist::g_castlingKeys[16];
+	ZobristKey Zobrist::g_enpassantKeys[8];
+
+	void Zobrist::Initialise()
+	{
+		//Function level statics are only initialised once (and are thread safe)
+		static const bool initialised = InitialiseKeys();
+		(void)initialised;
+	}
+
+	bool Zobrist::InitialiseKeys()
+	{
+		//Fixed seed so keys (and anything stored using them) are the same on each run
+		unsigned long long seed = 0x3243F6A8885A308DULL;
+		auto random = [&seed]()
+		{
+			//xorshift64*
+			seed ^= seed >> 12;
+			seed ^= seed << 25;
+			seed ^= seed >> 27;
+			return seed * 2685821657736338717ULL;
+		};
+
+		for (int colourIndex = 0; colourIndex < 2; ++colourIndex)
+		{
+			for (int pieceIndex = 0; pieceIndex < Piece::PieceTypeCount; ++pieceIndex)
+			{
+				for (int sq64 = 0; sq64 < 64; ++sq64)
+				{
+					g_pieceKeys[colourIndex][pieceIndex][sq64] = random();
+				}
+			}
+		}
+
+		g_blackToMoveKey = random();
+
+		//Each castling right has its own key, a set of rights is the XOR of them
+		ZobristKey castlingRightKeys[4];
+		for (int i = 0; i < 4; ++i)
+		{
+			castlingRightKeys[i] = random();
+		}
+		for (int rights = 0; rights < 16; ++rights)
+		{
+			g_castlingKeys[rights] = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				if ((rights & (1 << i)) != 0) g_castlingKeys[rights] ^= castlingRightKeys[i];
+			}
+		}
+
+		for (int file = 0; file < 8; ++file)
+		{
+			g_enpassantKeys[file] = random();
+		}
+
+		return true;
+	}
+}
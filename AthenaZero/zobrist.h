@@ -0,0 +1,95 @@
+/*
+	Part of the AthenaZero Chess Engine.
+
+	This file contains the random keys used to build Zobrist hash keys for
+	positions.
+
+	AthenaZero is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	AthenaZero is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATHENAZERO_ENGINE_ZOBRIST
+#define ATHENAZERO_ENGINE_ZOBRIST
+
+#include "typedefs.h"
+#include "piece.h"
+
+namespace ATHENAZEROENG
+{
+	/*
+		A position's key is the XOR of the keys for each piece on its square, the side to
+		move key if black is to move, the key for the castling rights and the key for the
+		enpassant file (if there is an enpassant square). Each part can be XORed in and out
+		as a move changes it.
+	*/
+	class Zobrist
+	{
+	public:
+		/*
+			Builds the key tables. Only does the work on the first call so is safe to call
+			more than once.
+		*/
+		static void Initialise();
+
+		/*
+			Gets the key for a piece on a square.
+
+			colourIndex: Piece::ColourIndexWhite or Piece::ColourIndexBlack.
+			pieceIndex: The piece type index (Piece::PieceIndexXXX, not PieceIndexNone).
+			sq64: The square (0-63).
+		*/
+		static inline ZobristKey GetPieceKey(int colourIndex, int pieceIndex, BoardIndex64 sq64)
+		{
+			return g_pieceKeys[colourIndex][pieceIndex][sq64];
+		}
+
+		/*
+			Gets the key XORed in when black is to move.
+		*/
+		static inline ZobristKey GetBlackToMoveKey()
+		{
+			return g_blackToMoveKey;
+		}
+
+		/*
+			Gets the key for a set of castling rights (BoardState::CastleXXX bits, 0-15).
+		*/
+		static inline ZobristKey GetCastlingKey(int castlingRights)
+		{
+			return g_castlingKeys[castlingRights];
+		}
+
+		/*
+			Gets the key for an enpassant square on a file (0-7).
+		*/
+		static inline ZobristKey GetEnpassantKey(int file)
+		{
+			return g_enpassantKeys[file];
+		}
+
+	private:
+		static ZobristKey g_pieceKeys[2][Piece::PieceTypeCount][64];
+		static ZobristKey g_blackToMoveKey;
+		static ZobristKey g_castlingKeys[16];
+		static ZobristKey g_enpassantKeys[8];
+
+		/*
+			Fills the tables. Called once by Initialise().
+
+			Returns: True (used to initialise a static).
+		*/
+		static bool InitialiseKeys();
+	};
+}
+
+#endif